@@ -1,8 +1,17 @@
+#include <array>
 #include <cassert>
+#include <charconv>
+#include <cstdlib>
+#include <functional>
+#include <memory_resource>
 #include <sstream>
 
+#include <attoparsecpp/incremental.hpp>
 #include <attoparsecpp/math_expression.hpp>
+#include <attoparsecpp/memo.hpp>
+#include <attoparsecpp/parallel.hpp>
 #include <attoparsecpp/parser.hpp>
+#include <attoparsecpp/small_vector.hpp>
 
 #include <benchmark/benchmark.h>
 
@@ -37,6 +46,88 @@ static void measure_word_parsing(benchmark::State &state) {
 
 BENCH_COMPLX(measure_word_parsing);
 
+static void measure_word_parsing_view(benchmark::State &state) {
+  const size_t size{static_cast<size_t>(state.range(0))};
+  const auto p{many_view(noneOf(' '))};
+  const std::string s{self_concat("a", size)};
+
+  for (auto _ : state) {
+    auto r{parse_result(p, s)->data()};
+    benchmark::DoNotOptimize(r);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+BENCH_COMPLX(measure_word_parsing_view);
+
+static void measure_word_parsing_take_while(benchmark::State &state) {
+  const size_t size{static_cast<size_t>(state.range(0))};
+  const auto p{take_while([](char c) { return c != ' '; })};
+  const std::string s{self_concat("a", size)};
+
+  for (auto _ : state) {
+    auto r{parse_result(p, s)->data()};
+    benchmark::DoNotOptimize(r);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+BENCH_COMPLX(measure_word_parsing_take_while);
+
+template <typename Parser>
+static void measure_run_scanning(benchmark::State &state, Parser p) {
+  const size_t size{static_cast<size_t>(state.range(0))};
+  std::string s{self_concat("a", size) + "#"};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(s.data());
+    auto r{parse_result(p, s)->size()};
+    benchmark::DoNotOptimize(r);
+  }
+  state.SetComplexityN(state.range(0));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+
+static void scan_word_scalar(benchmark::State &state) {
+  measure_run_scanning(state, many_view(sat([](char c) { return c != ' '; })));
+}
+
+BENCH_COMPLX(scan_word_scalar);
+
+static void scan_word_simd(benchmark::State &state) {
+  measure_run_scanning(state, many_view(noneOf(' ')));
+}
+
+BENCH_COMPLX(scan_word_simd);
+
+static void scan_packet_payload_scalar(benchmark::State &state) {
+  measure_run_scanning(state, many_view(sat([](char c) {
+                         return c != '#' && c != '$' && c != '}';
+                       })));
+}
+
+BENCH_COMPLX(scan_packet_payload_scalar);
+
+static void scan_packet_payload_simd(benchmark::State &state) {
+  measure_run_scanning(state, many_view(noneOf('#', '$', '}')));
+}
+
+BENCH_COMPLX(scan_packet_payload_simd);
+
+static void scan_hex_digits_one_of(benchmark::State &state) {
+  measure_run_scanning(state,
+                       many_view(oneOf('0', '1', '2', '3', '4', '5', '6', '7',
+                                       '8', '9', 'a', 'b', 'c', 'd', 'e', 'f')));
+}
+
+BENCH_COMPLX(scan_hex_digits_one_of);
+
+static void scan_hex_digits_class(benchmark::State &state) {
+  measure_run_scanning(state, many_view(sat(hex_digit_class)));
+}
+
+BENCH_COMPLX(scan_hex_digits_class);
+
 static void measure_vector_filling(benchmark::State &state) {
   const size_t size{static_cast<size_t>(state.range(0))};
   const auto p{manyV(token(integer), false, size)};
@@ -53,9 +144,323 @@ static void measure_vector_filling(benchmark::State &state) {
 
 BENCH_COMPLX(measure_vector_filling);
 
+// Like measure_vector_filling, but reuses one vector for all parses.
+static void measure_vector_filling_into(benchmark::State &state) {
+  const size_t size{static_cast<size_t>(state.range(0))};
+  const auto p{manyV_into(token(integer))};
+  const std::string s{self_concat("1 ", size)};
+  std::vector<int> v;
+
+  for (auto _ : state) {
+    parse_into(p, s, v);
+    auto res{v.data()};
+    benchmark::DoNotOptimize(res);
+    assert(v.size() == size);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+BENCH_COMPLX(measure_vector_filling_into);
+
+static constexpr size_t numbers_per_iteration{1000};
+
+static const char *short_number{"12345 "};
+static const char *long_number{"1234567890123456789 "};
+
+template <typename F>
+static void measure_number_parsing(benchmark::State &state, const char *number,
+                                   F parse_one) {
+  const std::string s{self_concat(number, numbers_per_iteration)};
+
+  for (auto _ : state) {
+    int64_t sum{0};
+    const char *it{s.data()};
+    const char *end{s.data() + s.size()};
+    while (it != end) {
+      it = parse_one(it, end, sum) + 1;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(
+      static_cast<int64_t>(state.iterations() * numbers_per_iteration));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * s.size()));
+}
+
+static const char *parse_int_apl(const char *it, const char *end,
+                                 int64_t &sum) {
+  str_pos pos{it, end};
+  sum += *base_integer<int64_t>(10)(pos);
+  return pos.data();
+}
+
+static const char *parse_int_from_chars(const char *it, const char *end,
+                                        int64_t &sum) {
+  int64_t v{0};
+  const auto r{std::from_chars(it, end, v)};
+  sum += v;
+  return r.ptr;
+}
+
+static const char *parse_int_strtol(const char *it, const char *,
+                                    int64_t &sum) {
+  char *rest;
+  sum += std::strtoll(it, &rest, 10);
+  return rest;
+}
+
+static void int_short_apl(benchmark::State &state) {
+  measure_number_parsing(state, short_number, parse_int_apl);
+}
+BENCHMARK(int_short_apl);
+
+static void int_short_from_chars(benchmark::State &state) {
+  measure_number_parsing(state, short_number, parse_int_from_chars);
+}
+BENCHMARK(int_short_from_chars);
+
+static void int_short_strtol(benchmark::State &state) {
+  measure_number_parsing(state, short_number, parse_int_strtol);
+}
+BENCHMARK(int_short_strtol);
+
+static void int_long_apl(benchmark::State &state) {
+  measure_number_parsing(state, long_number, parse_int_apl);
+}
+BENCHMARK(int_long_apl);
+
+static void int_long_from_chars(benchmark::State &state) {
+  measure_number_parsing(state, long_number, parse_int_from_chars);
+}
+BENCHMARK(int_long_from_chars);
+
+static void int_long_strtol(benchmark::State &state) {
+  measure_number_parsing(state, long_number, parse_int_strtol);
+}
+BENCHMARK(int_long_strtol);
+
+static void sum_of_doubles(benchmark::State &state) {
+  const size_t size{static_cast<size_t>(state.range(0))};
+  const std::string s{self_concat("3.14159 ", size)};
+  const auto p{token(double_)};
+
+  for (auto _ : state) {
+    double sum{0};
+    str_pos pos{s};
+    while (const auto r{p(pos)}) {
+      sum += *r;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetComplexityN(state.range(0));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * s.size()));
+}
+
+BENCH_COMPLX(sum_of_doubles);
+
+static void sum_of_doubles_stod(benchmark::State &state) {
+  const size_t size{static_cast<size_t>(state.range(0))};
+  const std::string s{self_concat("3.14159 ", size)};
+  const auto p{token(map(many1(sat(digit_class | chars<'.', '-', 'e'>)),
+                         [](const std::string &f) { return std::stod(f); }))};
+
+  for (auto _ : state) {
+    double sum{0};
+    str_pos pos{s};
+    while (const auto r{p(pos)}) {
+      sum += *r;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetComplexityN(state.range(0));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * s.size()));
+}
+
+BENCH_COMPLX(sum_of_doubles_stod);
+
+static const char *long_keyword{"begin_transaction_isolation"};
+
+template <typename Parser>
+static void measure_keyword_matching(benchmark::State &state, Parser p) {
+  const size_t size{static_cast<size_t>(state.range(0))};
+  const std::string s{self_concat(long_keyword, size)};
+
+  for (auto _ : state) {
+    size_t n{0};
+    str_pos pos{s};
+    while (p(pos)) {
+      ++n;
+    }
+    benchmark::DoNotOptimize(n);
+    assert(n == size);
+  }
+  state.SetComplexityN(state.range(0));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * s.size()));
+}
+
+static void keywords_const_string(benchmark::State &state) {
+  measure_keyword_matching(state, const_string(long_keyword));
+}
+
+BENCH_COMPLX(keywords_const_string);
+
+static void keywords_const_string_view(benchmark::State &state) {
+  measure_keyword_matching(state, const_string_view(long_keyword));
+}
+
+BENCH_COMPLX(keywords_const_string_view);
+
+static void keywords_skip_string(benchmark::State &state) {
+  measure_keyword_matching(state, skip_string(long_keyword));
+}
+
+BENCH_COMPLX(keywords_skip_string);
+
+static constexpr std::array<const char *, 20> commands{
+    "break", "continue", "delete", "disable", "display", "enable", "finish",
+    "frame", "info",     "jump",   "kill",    "list",    "next",   "print",
+    "quit",  "run",      "set",    "step",    "until",   "watch"};
+
+template <typename Parser>
+static void measure_command_dispatch(benchmark::State &state, Parser p) {
+  const size_t size{static_cast<size_t>(state.range(0))};
+  std::string s;
+  for (size_t i{0}; i < size; ++i) {
+    s += commands[(i * 7) % commands.size()];
+    s += '\n';
+  }
+
+  for (auto _ : state) {
+    size_t n{0};
+    str_pos pos{s};
+    while (p(pos) && oneOf('\n')(pos)) {
+      ++n;
+    }
+    benchmark::DoNotOptimize(n);
+    assert(n == size);
+  }
+  state.SetComplexityN(state.range(0));
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+
+template <typename F, size_t... Is>
+static auto command_grammar(F combine, std::index_sequence<Is...>) {
+  return combine(skip_string(commands[Is])...);
+}
+
+static constexpr auto linear_choice{[](auto... ps) { return choice(ps...); }};
+static constexpr auto first_set_choice{
+    [](auto... ps) { return choice_first(ps...); }};
+
+template <typename F>
+static void measure_commands(benchmark::State &state, F f) {
+  measure_command_dispatch(
+      state, command_grammar(f, std::make_index_sequence<commands.size()>{}));
+}
+
+// Builds the choice anew on every call, like parser functions such as
+// bt_atom() below do.
+template <typename F>
+static void measure_commands_per_call(benchmark::State &state, F f) {
+  measure_command_dispatch(state, [f](str_pos &pos) {
+    return command_grammar(f, std::make_index_sequence<commands.size()>{})(pos);
+  });
+}
+
+static void command_dispatch_linear(benchmark::State &state) {
+  measure_commands(state, linear_choice);
+}
+
+BENCH_COMPLX(command_dispatch_linear);
+
+static void command_dispatch_first_set(benchmark::State &state) {
+  measure_commands(state, first_set_choice);
+}
+
+BENCH_COMPLX(command_dispatch_first_set);
+
+static void command_dispatch_linear_per_call(benchmark::State &state) {
+  measure_commands_per_call(state, linear_choice);
+}
+
+BENCH_COMPLX(command_dispatch_linear_per_call);
+
+static void command_dispatch_first_set_per_call(benchmark::State &state) {
+  measure_commands_per_call(state, first_set_choice);
+}
+
+BENCH_COMPLX(command_dispatch_first_set_per_call);
+
+/*
+ * The same left associative sum with Levels precedence levels, each with its
+ * own operator character, parsed once by a tower of chainl1 and once by
+ * expression().
+ */
+
+static constexpr std::array<char, 10> level_ops{'|', '^', '&', '<', '>',
+                                                '+', '-', '*', '/', '%'};
+
+static std::string precedence_input(size_t levels) {
+  std::string s{"1"};
+  for (size_t i{0}; i < 10000; ++i) {
+    s += ' ';
+    s += level_ops[i % levels];
+    s += " 1";
+  }
+  return s;
+}
+
+template <size_t Level, size_t Levels> static parser<int> tower(str_pos &p) {
+  if constexpr (Level == Levels) {
+    return token(integer)(p);
+  } else {
+    const auto op{map(token(oneOf(level_ops[Level])),
+                      [](char) -> int (*)(int, int) {
+                        return [](int a, int b) { return a + b; };
+                      })};
+    return chainl1(tower<Level + 1, Levels>, op)(p);
+  }
+}
+
+template <size_t Levels>
+static void precedence_chainl1(benchmark::State &state) {
+  const std::string s{precedence_input(Levels)};
+
+  for (auto _ : state) {
+    const auto r{parse_result(tower<0, Levels>, s)};
+    benchmark::DoNotOptimize(r);
+    assert(r == 10001);
+  }
+}
+
+template <size_t... Is>
+static auto precedence_table(std::index_sequence<Is...>) {
+  const auto add{[](char, int a, int b) { return a + b; }};
+  return operator_table(infix_left(token(oneOf(level_ops[Is])), add)...);
+}
+
+template <size_t Levels>
+static void precedence_expression(benchmark::State &state) {
+  const std::string s{precedence_input(Levels)};
+  const auto table{precedence_table(std::make_index_sequence<Levels>{})};
+  const auto p{expression(token(integer), table)};
+
+  for (auto _ : state) {
+    const auto r{parse_result(p, s)};
+    benchmark::DoNotOptimize(r);
+    assert(r == 10001);
+  }
+}
+
+BENCHMARK_TEMPLATE(precedence_chainl1, 2);
+BENCHMARK_TEMPLATE(precedence_chainl1, 5);
+BENCHMARK_TEMPLATE(precedence_chainl1, 10);
+BENCHMARK_TEMPLATE(precedence_expression, 2);
+BENCHMARK_TEMPLATE(precedence_expression, 5);
+BENCHMARK_TEMPLATE(precedence_expression, 10);
+
 static auto csv_line(size_t reserve_items = 0) {
   return [reserve_items](str_pos pos) {
-    const auto comma_whitespace{prefixed(oneOf(','), many(oneOf(' ')))};
+    const auto comma_whitespace{prefixed(oneOf(','), skip_many(oneOf(' ')))};
     return sep_by1(integer, comma_whitespace, reserve_items)(pos);
   };
 }
@@ -77,6 +482,40 @@ static void csv_vector_of_ints(benchmark::State &state) {
 
 BENCH_COMPLX(csv_vector_of_ints);
 
+static void csv_sum_of_ints(benchmark::State &state) {
+  const size_t size{static_cast<size_t>(state.range(0))};
+  assert(size > 0);
+  const std::string s{std::string{"1"} + self_concat(", 1", size - 1)};
+  const auto comma_whitespace{prefixed(oneOf(','), skip_many(oneOf(' ')))};
+  const auto p{sep_by_fold(integer, comma_whitespace, size_t{0},
+                           [](size_t sum, int i) { return sum + i; })};
+
+  for (auto _ : state) {
+    const auto r{parse_result(p, s)};
+    benchmark::DoNotOptimize(r);
+    assert(r == size);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+BENCH_COMPLX(csv_sum_of_ints);
+
+static void csv_count_of_ints(benchmark::State &state) {
+  const size_t size{static_cast<size_t>(state.range(0))};
+  assert(size > 0);
+  const std::string s{std::string{"1 "} + self_concat("1 ", size - 1)};
+  const auto p{many_count(token(integer))};
+
+  for (auto _ : state) {
+    const auto r{parse_result(p, s)};
+    benchmark::DoNotOptimize(r);
+    assert(r == size);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+BENCH_COMPLX(csv_count_of_ints);
+
 static void sum_of_ints(benchmark::State &state) {
   const auto size{static_cast<int>(state.range(0))};
   assert(size > 0);
@@ -109,4 +548,241 @@ static void product_of_ints(benchmark::State &state) {
 
 BENCH_COMPLX(product_of_ints);
 
+/*
+ * Backtracking grammar that tries the same atom up to three times:
+ *
+ * bt_expr = try (atom '+' bt_expr) <|> try (atom '-' bt_expr) <|> atom
+ * atom    = digit <|> '(' bt_expr ')'
+ *
+ * Without memoization, nested parentheses take exponential time.
+ */
+template <bool Memoize> static parser<int> bt_expr(str_pos &p);
+
+template <bool Memoize> static parser<int> bt_atom(str_pos &p) {
+  return choice(map(number, [](char c) { return c - '0'; }),
+                clasped(oneOf('('), oneOf(')'), bt_expr<Memoize>))(p);
+}
+
+template <bool Memoize> static parser<int> bt_expr(str_pos &p) {
+  static const auto atom{[] {
+    if constexpr (Memoize) {
+      return memo(bt_atom<true>);
+    } else {
+      return bt_atom<false>;
+    }
+  }()};
+  const auto binary{[](char op, auto f) {
+    return attempt(map(tuple_of(atom, oneOf(op), bt_expr<Memoize>),
+                       [f](const auto &t) {
+                         return f(std::get<0>(t), std::get<2>(t));
+                       }));
+  }};
+  return choice(binary('+', std::plus<>{}), binary('-', std::minus<>{}),
+                atom)(p);
+}
+
+static std::string nested_parentheses(size_t depth) {
+  return self_concat("(", depth) + "1" + self_concat(")", depth);
+}
+
+static void backtracking_plain(benchmark::State &state) {
+  const std::string s{nested_parentheses(static_cast<size_t>(state.range(0)))};
+
+  for (auto _ : state) {
+    const auto r{parse_result(bt_expr<false>, s)};
+    benchmark::DoNotOptimize(r);
+    assert(r == 1);
+  }
+}
+
+BENCHMARK(backtracking_plain)->DenseRange(2, 12, 2);
+
+static void backtracking_memo(benchmark::State &state) {
+  const std::string s{nested_parentheses(static_cast<size_t>(state.range(0)))};
+  memo_table table;
+
+  for (auto _ : state) {
+    const auto r{parse_result(bt_expr<true>, s, table)};
+    benchmark::DoNotOptimize(r);
+    assert(r == 1);
+  }
+}
+
+BENCHMARK(backtracking_memo)->DenseRange(2, 12, 2);
+
+static constexpr size_t stream_chunk_size{4096};
+
+static auto csv_stream_line() {
+  return postfixed(oneOf('\n'), sep_by(integer, oneOf(',')));
+}
+
+static void stream_reparse(benchmark::State &state) {
+  const size_t size{static_cast<size_t>(state.range(0))};
+  const std::string s{self_concat("1,2,3\n", size)};
+  const auto p{manyV(csv_stream_line())};
+
+  for (auto _ : state) {
+    std::string buffer;
+    size_t lines{0};
+    for (size_t i{0}; i < s.size(); i += stream_chunk_size) {
+      buffer.append(s, i, stream_chunk_size);
+      lines = parse_result(p, buffer)->size();
+    }
+    benchmark::DoNotOptimize(lines);
+    assert(lines == size);
+  }
+  state.SetComplexityN(state.range(0));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * s.size()));
+}
+
+BENCHMARK(stream_reparse)
+    ->RangeMultiplier(10)
+    ->Range(1000, 100000)
+    ->Complexity(benchmark::oNSquared);
+
+static void stream_incremental(benchmark::State &state) {
+  const size_t size{static_cast<size_t>(state.range(0))};
+  const std::string s{self_concat("1,2,3\n", size)};
+  const std::string_view sv{s};
+
+  for (auto _ : state) {
+    size_t lines{0};
+    incremental_items p{csv_stream_line(),
+                        [&lines](const std::vector<int> &) { ++lines; }, true};
+    for (size_t i{0}; i < s.size(); i += stream_chunk_size) {
+      p.feed(sv.substr(i, stream_chunk_size));
+    }
+    p.finish();
+    benchmark::DoNotOptimize(lines);
+    assert(lines == size);
+  }
+  state.SetComplexityN(state.range(0));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * s.size()));
+}
+
+BENCHMARK(stream_incremental)
+    ->RangeMultiplier(10)
+    ->Range(1000, 100000)
+    ->Complexity(benchmark::oN);
+
+// One message of size lines, fed to incremental<> chunk by chunk. Every
+// chunk parses the message again from its start, like stream_reparse.
+static void stream_single_message(benchmark::State &state) {
+  const size_t size{static_cast<size_t>(state.range(0))};
+  const std::string s{self_concat("1,2,3\n", size) + "."};
+  const std::string_view sv{s};
+
+  for (auto _ : state) {
+    incremental p{many_count(csv_stream_line())};
+    for (size_t i{0}; i < s.size(); i += stream_chunk_size) {
+      p.feed(sv.substr(i, stream_chunk_size));
+    }
+    p.finish();
+    benchmark::DoNotOptimize(p.result());
+    assert(p.result() == size);
+  }
+  state.SetComplexityN(state.range(0));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * s.size()));
+}
+
+BENCHMARK(stream_single_message)
+    ->RangeMultiplier(10)
+    ->Range(1000, 100000)
+    ->Complexity(benchmark::oNSquared);
+
+template <typename Allocator> static auto nested_lists(Allocator alloc) {
+  const auto list{clasped(oneOf('['), oneOf(']'),
+                          sep_by_alloc(token(integer), token(oneOf(',')),
+                                       alloc))};
+  return manyV_alloc(token(list), alloc);
+}
+
+static void nested_lists_global_heap(benchmark::State &state) {
+  const size_t size{static_cast<size_t>(state.range(0))};
+  const std::string s{self_concat("[1, 2, 3, 4] ", size)};
+  const auto p{nested_lists(std::allocator<int>{})};
+
+  for (auto _ : state) {
+    const auto r{parse_result(p, s)};
+    benchmark::DoNotOptimize(r->data());
+    assert(r->size() == size);
+  }
+  state.SetComplexityN(state.range(0));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * s.size()));
+}
+
+BENCH_COMPLX(nested_lists_global_heap);
+
+static void nested_lists_arena(benchmark::State &state) {
+  const size_t size{static_cast<size_t>(state.range(0))};
+  const std::string s{self_concat("[1, 2, 3, 4] ", size)};
+  std::vector<std::byte> buffer(size * 128);
+
+  for (auto _ : state) {
+    std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size()};
+    const auto p{nested_lists(std::pmr::polymorphic_allocator<int>{&arena})};
+    const auto r{parse_result(p, s)};
+    benchmark::DoNotOptimize(r->data());
+    assert(r->size() == size);
+  }
+  state.SetComplexityN(state.range(0));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * s.size()));
+}
+
+BENCH_COMPLX(nested_lists_arena);
+
+static void parallel_csv_records(benchmark::State &state) {
+  const size_t threads{static_cast<size_t>(state.range(0))};
+  const size_t records{1000000};
+  const std::string s{self_concat("12, 345, 6789, 10, 11121314\n", records)};
+  const auto comma_whitespace{prefixed(oneOf(','), skip_many(oneOf(' ')))};
+  const auto line{sep_by_fold(integer, comma_whitespace, int64_t{0},
+                              [](int64_t sum, int i) { return sum + i; })};
+
+  for (auto _ : state) {
+    const auto r{parallel_parse_records(line, s, '\n', threads)};
+    benchmark::DoNotOptimize(r.results.data());
+    assert(r.results.size() == records && r.failures.empty());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * s.size()));
+}
+
+BENCHMARK(parallel_csv_records)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+// Many short lists like [0,1,2], as in argument lists. Every list is
+// collected in its own container by list_parser.
+template <typename ListParser>
+static void measure_short_lists(benchmark::State &state,
+                                ListParser list_parser) {
+  constexpr size_t lists{1000};
+  const size_t length{static_cast<size_t>(state.range(0))};
+  std::string list{"["};
+  for (size_t i{0}; i < length; ++i) {
+    list += (i ? "," : "") + std::to_string(i);
+  }
+  list += "] ";
+  const std::string s{self_concat(list.c_str(), lists)};
+  const auto p{many_fold(
+      token(clasped(oneOf('['), oneOf(']'), list_parser)), size_t{0},
+      [](size_t n, const auto &items) { return n + items.size(); })};
+
+  for (auto _ : state) {
+    const auto r{parse_result(p, s)};
+    benchmark::DoNotOptimize(r);
+    assert(r == lists * length);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * lists));
+}
+
+static void short_lists_sep_by(benchmark::State &state) {
+  measure_short_lists(state, sep_by(integer, oneOf(',')));
+}
+
+static void short_lists_sep_by_small(benchmark::State &state) {
+  measure_short_lists(state, sep_by_small<8>(integer, oneOf(',')));
+}
+
+BENCHMARK(short_lists_sep_by)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
+BENCHMARK(short_lists_sep_by_small)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
+
 BENCHMARK_MAIN();
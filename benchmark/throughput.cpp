@@ -0,0 +1,914 @@
+#include <charconv>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <attoparsecpp/csv.hpp>
+#include <attoparsecpp/gdb_remote.hpp>
+#include <attoparsecpp/json.hpp>
+#include <attoparsecpp/math_expression.hpp>
+#include <attoparsecpp/parser.hpp>
+
+#include <benchmark/benchmark.h>
+
+/*
+ * Throughput of realistic inputs, in bytes and records per second.
+ * Every workload is parsed once with combinators and once with a hand
+ * written parser that computes the same checksum, so the difference between
+ * the two is the overhead of the combinators.
+ */
+
+using namespace apl;
+
+namespace {
+
+struct workload {
+  std::string input;
+  size_t records;
+};
+
+template <typename F>
+void measure_throughput(benchmark::State &state, const workload &w, F parse) {
+  const auto expected{parse(w.input)};
+  for (auto _ : state) {
+    const auto r{parse(w.input)};
+    benchmark::DoNotOptimize(r);
+    if (r != expected) {
+      state.SkipWithError("result differs from the first run");
+      break;
+    }
+  }
+  state.SetBytesProcessed(
+      static_cast<int64_t>(state.iterations() * w.input.size()));
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * w.records));
+}
+
+// Parses a decimal integer in the hand written baselines.
+const char *scan_int(const char *it, const char *end, int &out) {
+  const auto r{std::from_chars(it, end, out)};
+  return r.ec == std::errc{} ? r.ptr : nullptr;
+}
+
+constexpr size_t records{100000};
+
+// CSV with mixed field types: id,name,price,quantity
+//   17,widget_17,17.375,18
+
+const workload &csv_workload() {
+  static const workload w{[] {
+    std::string s;
+    for (size_t i{0}; i < records; ++i) {
+      s += std::to_string(i) + ",widget_" + std::to_string(i % 997) + "," +
+           std::to_string(i % 100) + "." + std::to_string(i % 7 * 125) +
+           "," + std::to_string(i % 50 + 1) + "\n";
+    }
+    return workload{s, records};
+  }()};
+  return w;
+}
+
+double csv_apl(std::string_view s) {
+  const auto comma{oneOf(',')};
+  const auto row{tuple_of(postfixed(comma, integer),
+                          postfixed(comma, take_while1(alnum_class |
+                                                       chars<'_'>)),
+                          postfixed(comma, double_),
+                          postfixed(oneOf('\n'), integer))};
+  const auto rows{many_fold(row, 0.0, [](double sum, const auto &r) {
+    const auto &[id, name, price, quantity]{r};
+    return sum + id + static_cast<double>(name.size()) + price * quantity;
+  })};
+  str_pos pos{s};
+  const auto r{rows(pos)};
+  return r && pos.at_end() ? *r : -1.0;
+}
+
+double csv_baseline(std::string_view s) {
+  double sum{0.0};
+  const char *it{s.data()};
+  const char *const end{it + s.size()};
+  while (it != end) {
+    int id{0};
+    int quantity{0};
+    double price{0.0};
+    if (!(it = scan_int(it, end, id)) || *it++ != ',') {
+      return -1.0;
+    }
+    const char *name{it};
+    while (it != end && (alnum_class(*it) || *it == '_')) {
+      ++it;
+    }
+    if (it == name || it == end || *it++ != ',') {
+      return -1.0;
+    }
+    const size_t name_size{static_cast<size_t>(it - 1 - name)};
+    const auto r{std::from_chars(it, end, price)};
+    if (r.ec != std::errc{} || (it = r.ptr) == end || *it++ != ',') {
+      return -1.0;
+    }
+    if (!(it = scan_int(it, end, quantity)) || it == end || *it++ != '\n') {
+      return -1.0;
+    }
+    sum += id + static_cast<double>(name_size) + price * quantity;
+  }
+  return sum;
+}
+
+// Log lines of key=value pairs. The checksum adds up the latencies.
+//   ts=1700000017 level=info user=u17 latency_ms=42 msg=request_done
+
+const workload &log_workload() {
+  static const workload w{[] {
+    static const char *const levels[]{"debug", "info", "warn", "error"};
+    std::string s;
+    for (size_t i{0}; i < records; ++i) {
+      s += "ts=" + std::to_string(1700000000 + i) + " level=" + levels[i % 4] +
+           " user=u" + std::to_string(i % 311) +
+           " latency_ms=" + std::to_string(i % 1000) +
+           " msg=request_done\n";
+    }
+    return workload{s, records};
+  }()};
+  return w;
+}
+
+int64_t latency_of(std::string_view key, std::string_view value) {
+  int latency{0};
+  if (key == "latency_ms") {
+    std::from_chars(value.data(), value.data() + value.size(), latency);
+  }
+  return latency;
+}
+
+int64_t log_apl(std::string_view s) {
+  const auto key{take_while1(alnum_class | chars<'_'>)};
+  const auto value{take_while1(~chars<' ', '\n'>)};
+  const auto pair{tuple_of(postfixed(oneOf('='), key), value)};
+  const auto line{postfixed(
+      oneOf('\n'),
+      sep_by_fold(pair, oneOf(' '), int64_t{0}, [](int64_t sum, auto kv) {
+        return sum + latency_of(std::get<0>(kv), std::get<1>(kv));
+      }))};
+  const auto lines{
+      many_fold(line, int64_t{0}, [](int64_t a, int64_t b) { return a + b; })};
+  str_pos pos{s};
+  const auto r{lines(pos)};
+  return r && pos.at_end() ? *r : -1;
+}
+
+int64_t log_baseline(std::string_view s) {
+  int64_t sum{0};
+  size_t i{0};
+  while (i < s.size()) {
+    const size_t eq{s.find('=', i)};
+    if (eq == std::string_view::npos) {
+      return -1;
+    }
+    size_t value_end{eq + 1};
+    while (value_end < s.size() && s[value_end] != ' ' &&
+           s[value_end] != '\n') {
+      ++value_end;
+    }
+    if (value_end == s.size()) {
+      return -1;
+    }
+    sum += latency_of(s.substr(i, eq - i),
+                      s.substr(eq + 1, value_end - eq - 1));
+    i = value_end + 1;
+  }
+  return sum;
+}
+
+// GDB remote protocol packets: $payload#checksum
+
+const workload &gdb_workload() {
+  static const workload w{[] {
+    static const char *const payloads[]{
+        "qSupported:multiprocess+;swbreak+;hwbreakpoints+",
+        "vMustReplyEmpty", "Hg0", "qTStatus", "?",
+        "m7ffff7fe3290,40", "Z0,7ffff7fe3290,1", "vCont;c:p1.-1"};
+    std::string s;
+    for (size_t i{0}; i < records; ++i) {
+      const std::string_view payload{payloads[i % 8]};
+      uint8_t checksum{0};
+      for (char c : payload) {
+        checksum += static_cast<uint8_t>(c);
+      }
+      static const char hex[]{"0123456789abcdef"};
+      s += "$";
+      s += payload;
+      s += "#";
+      s += hex[checksum >> 4];
+      s += hex[checksum & 0xf];
+    }
+    return workload{s, records};
+  }()};
+  return w;
+}
+
+uint8_t checksum_of(std::string_view payload) {
+  uint8_t checksum{0};
+  for (char c : payload) {
+    checksum += static_cast<uint8_t>(c);
+  }
+  return checksum;
+}
+
+size_t gdb_apl(std::string_view s) {
+  const auto packet{[](str_pos &pos) -> parser<unit> {
+    const auto payload{
+        clasped(oneOf('$'), oneOf('#'), many_view(noneOf('#')))(pos)};
+    if (payload && base_integer<uint8_t>(16, 2)(pos) == checksum_of(*payload)) {
+      return {unit{}};
+    }
+    return {};
+  }};
+  str_pos pos{s};
+  const auto r{many_count(packet)(pos)};
+  return pos.at_end() ? *r : 0;
+}
+
+size_t gdb_baseline(std::string_view s) {
+  size_t packets{0};
+  size_t i{0};
+  while (i < s.size()) {
+    if (s[i] != '$') {
+      return 0;
+    }
+    const size_t hash{s.find('#', i + 1)};
+    if (hash == std::string_view::npos || hash + 3 > s.size()) {
+      return 0;
+    }
+    unsigned checksum{0};
+    const auto r{std::from_chars(s.data() + hash + 1, s.data() + hash + 3,
+                                 checksum, 16)};
+    if (r.ptr != s.data() + hash + 3 ||
+        checksum != checksum_of(s.substr(i + 1, hash - i - 1))) {
+      return 0;
+    }
+    ++packets;
+    i = hash + 3;
+  }
+  return packets;
+}
+
+// Nested arithmetic, one expression per line, parsed with math_expression.hpp
+//   (3 + 4 * (5 - 2)) * 7 - (1 + 8) * 2
+
+void append_expression(std::string &s, size_t depth, size_t &seed) {
+  const auto atom{[&] {
+    if (depth == 0) {
+      s += std::to_string(seed++ % 9 + 1);
+    } else {
+      s += '(';
+      append_expression(s, depth - 1, seed);
+      s += ')';
+    }
+  }};
+  static const char *const ops[]{" + ", " * ", " - ", " + "};
+  atom();
+  for (size_t i{0}; i < 2; ++i) {
+    s += ops[seed++ % 4];
+    atom();
+  }
+}
+
+const workload &arithmetic_workload() {
+  static const workload w{[] {
+    std::string s;
+    size_t seed{0};
+    for (size_t i{0}; i < records / 10; ++i) {
+      append_expression(s, 2, seed);
+      s += '\n';
+    }
+    return workload{s, records / 10};
+  }()};
+  return w;
+}
+
+int64_t arithmetic_apl(std::string_view s) {
+  const auto line{postfixed(oneOf('\n'), expr)};
+  const auto lines{
+      many_fold(line, int64_t{0}, [](int64_t a, int b) { return a + b; })};
+  str_pos pos{s};
+  const auto r{lines(pos)};
+  return r && pos.at_end() ? *r : -1;
+}
+
+// Recursive descent with the same grammar as math_expression.hpp.
+struct arithmetic_baseline_parser {
+  const char *it;
+  const char *end;
+
+  void skip_blanks() {
+    while (it != end && (*it == ' ' || *it == '\t')) {
+      ++it;
+    }
+  }
+
+  bool factor(int &out) {
+    if (it != end && *it == '(') {
+      ++it;
+      if (!expression(out) || it == end || *it++ != ')') {
+        return false;
+      }
+    } else if (!(it = scan_int(it, end, out))) {
+      return false;
+    }
+    skip_blanks();
+    return true;
+  }
+
+  bool term(int &out) {
+    if (!factor(out)) {
+      return false;
+    }
+    while (it != end && (*it == '*' || *it == '/')) {
+      const char op{*it++};
+      skip_blanks();
+      int rhs{0};
+      if (!factor(rhs)) {
+        return false;
+      }
+      out = op == '*' ? out * rhs : out / rhs;
+    }
+    return true;
+  }
+
+  bool expression(int &out) {
+    if (!term(out)) {
+      return false;
+    }
+    while (it != end && (*it == '+' || *it == '-')) {
+      const char op{*it++};
+      skip_blanks();
+      int rhs{0};
+      if (!term(rhs)) {
+        return false;
+      }
+      out = op == '+' ? out + rhs : out - rhs;
+    }
+    return true;
+  }
+};
+
+int64_t arithmetic_baseline(std::string_view s) {
+  arithmetic_baseline_parser p{s.data(), s.data() + s.size()};
+  int64_t sum{0};
+  while (p.it != p.end) {
+    int value{0};
+    if (!p.expression(value) || p.it == p.end || *p.it++ != '\n') {
+      return -1;
+    }
+    sum += value;
+  }
+  return sum;
+}
+
+// JSON event payloads, one object per event in a top level array.
+
+const workload &json_workload() {
+  static const workload w{[] {
+    static const char *const types[]{"click", "view", "purchase", "scroll"};
+    std::string s{"["};
+    for (size_t i{0}; i < records; ++i) {
+      s += i ? ",\n" : "\n";
+      s += R"(  {"id": )" + std::to_string(i) + R"(, "type": ")" +
+           types[i % 4] + R"(", "user": {"name": "user_)" +
+           std::to_string(i % 311) +
+           R"(", "tags": ["beta", "mobile"], "premium": )" +
+           (i % 3 ? "false" : "true") + R"(}, "ts": 1700000000.)" +
+           std::to_string(i % 1000) + R"(, "payload": {"x": )" +
+           std::to_string(i % 640) + R"(.5, "y": -)" +
+           std::to_string(i % 480) +
+           R"(, "path": "/home/\"user\"/ä", "note": null}})";
+    }
+    s += "\n]\n";
+    return workload{s, records};
+  }()};
+  return w;
+}
+
+struct json_counter : json_handler {
+  size_t values{0};
+  int64_t integers{0};
+
+  void null() { ++values; }
+  void boolean(bool) { ++values; }
+  void integer(int64_t i) {
+    ++values;
+    integers += i;
+  }
+  void number(double) { ++values; }
+  void string(std::string_view s) { values += !s.empty(); }
+};
+
+int64_t json_apl(std::string_view s) {
+  json_counter c;
+  return parse_json(s, c) ? c.integers : -1;
+}
+
+// Recursive descent over the same JSON subset, summing the integers like
+// json_counter. Strings are validated but not decoded.
+struct json_baseline_parser {
+  const char *it;
+  const char *end;
+  int64_t integers{0};
+  size_t depth{0};
+
+  void skip_space() {
+    while (it != end &&
+           (*it == ' ' || *it == '\t' || *it == '\n' || *it == '\r')) {
+      ++it;
+    }
+  }
+
+  bool literal(std::string_view word) {
+    if (static_cast<size_t>(end - it) < word.size() ||
+        std::string_view{it, word.size()} != word) {
+      return false;
+    }
+    it += word.size();
+    return true;
+  }
+
+  bool string() {
+    ++it;
+    while (it != end) {
+      const char c{*it++};
+      if (c == '"') {
+        return true;
+      }
+      if (static_cast<unsigned char>(c) < 0x20) {
+        return false;
+      }
+      if (c != '\\') {
+        continue;
+      }
+      if (it == end) {
+        return false;
+      }
+      const char escaped{*it++};
+      if (escaped == 'u') {
+        for (int i{0}; i < 4; ++i) {
+          if (it == end || !hex_digit_class(*it++)) {
+            return false;
+          }
+        }
+      } else if (std::string_view{"\"\\/bfnrt"}.find(escaped) ==
+                 std::string_view::npos) {
+        return false;
+      }
+    }
+    return false;
+  }
+
+  void skip_digits() {
+    while (it != end && digit_class(*it)) {
+      ++it;
+    }
+  }
+
+  bool number() {
+    const char *const b{it};
+    if (it != end && *it == '-') {
+      ++it;
+    }
+    if (it == end || !digit_class(*it)) {
+      return false;
+    }
+    if (*it++ != '0') {
+      skip_digits();
+    }
+    bool integral{true};
+    if (it != end && *it == '.') {
+      const char *const fraction{++it};
+      skip_digits();
+      if (it == fraction) {
+        return false;
+      }
+      integral = false;
+    }
+    if (it != end && (*it == 'e' || *it == 'E')) {
+      if (++it != end && (*it == '+' || *it == '-')) {
+        ++it;
+      }
+      const char *const exponent{it};
+      skip_digits();
+      if (it == exponent) {
+        return false;
+      }
+      integral = false;
+    }
+    if (integral) {
+      int64_t i{0};
+      if (std::from_chars(b, it, i).ec == std::errc{}) {
+        integers += i;
+        return true;
+      }
+    }
+    double d{0.0};
+    return std::from_chars(b, it, d).ec == std::errc{};
+  }
+
+  bool array() {
+    ++it;
+    skip_space();
+    if (it != end && *it == ']') {
+      ++it;
+      return true;
+    }
+    for (;;) {
+      if (!value() || it == end) {
+        return false;
+      }
+      const char c{*it++};
+      if (c == ']') {
+        return true;
+      }
+      if (c != ',') {
+        return false;
+      }
+    }
+  }
+
+  bool object() {
+    ++it;
+    skip_space();
+    if (it != end && *it == '}') {
+      ++it;
+      return true;
+    }
+    for (;;) {
+      if (it == end || *it != '"' || !string()) {
+        return false;
+      }
+      skip_space();
+      if (it == end || *it++ != ':' || !value() || it == end) {
+        return false;
+      }
+      const char c{*it++};
+      if (c == '}') {
+        return true;
+      }
+      if (c != ',') {
+        return false;
+      }
+      skip_space();
+    }
+  }
+
+  bool value() {
+    skip_space();
+    if (it == end) {
+      return false;
+    }
+    bool ok{false};
+    switch (*it) {
+    case '{':
+    case '[':
+      if (++depth > json_max_depth) {
+        return false;
+      }
+      ok = *it == '{' ? object() : array();
+      --depth;
+      break;
+    case '"':
+      ok = string();
+      break;
+    case 't':
+      ok = literal("true");
+      break;
+    case 'f':
+      ok = literal("false");
+      break;
+    case 'n':
+      ok = literal("null");
+      break;
+    default:
+      ok = number();
+    }
+    skip_space();
+    return ok;
+  }
+};
+
+int64_t json_baseline(std::string_view s) {
+  json_baseline_parser p{s.data(), s.data() + s.size()};
+  return p.value() && p.it == p.end ? p.integers : -1;
+}
+
+void throughput_json_apl(benchmark::State &state) {
+  const json_counter expected{[] {
+    json_counter c;
+    parse_json(json_workload().input, c);
+    return c;
+  }()};
+  if (expected.values != records * 11) {
+    state.SkipWithError("unexpected number of JSON values");
+    return;
+  }
+  measure_throughput(state, json_workload(), json_apl);
+}
+
+BENCHMARK(throughput_json_apl);
+
+void throughput_json_baseline(benchmark::State &state) {
+  if (json_apl(json_workload().input) != json_baseline(json_workload().input)) {
+    state.SkipWithError("baseline and combinators disagree");
+    return;
+  }
+  measure_throughput(state, json_workload(), json_baseline);
+}
+
+BENCHMARK(throughput_json_baseline);
+
+// Memory read traffic of a debug stub: acknowledged replies with 256 bytes
+// of memory in hex. The stream is fed in chunks of a TCP segment, so packets
+// are split anywhere. The checksum counts packets and their payload bytes.
+
+const workload &gdb_memory_workload() {
+  static const workload w{[] {
+    static const char hex[]{"0123456789abcdef"};
+    std::string s;
+    const size_t packets{records / 20};
+    for (size_t i{0}; i < packets; ++i) {
+      std::string payload;
+      for (size_t b{0}; b < 256; ++b) {
+        const size_t byte{(i * 31 + b * 7) & 0xff};
+        payload += hex[byte >> 4];
+        payload += hex[byte & 0xf];
+      }
+      const uint8_t checksum{checksum_of(payload)};
+      s += "+$" + payload + "#" + hex[checksum >> 4] + hex[checksum & 0xf];
+    }
+    return workload{s, packets};
+  }()};
+  return w;
+}
+
+size_t gdb_memory_apl(std::string_view s) {
+  constexpr size_t segment{1460};
+  size_t sum{0};
+  gdb_stream stream;
+  for (size_t i{0}; i < s.size(); i += segment) {
+    stream.feed(s.substr(i, segment), [&sum](const gdb_message &m) {
+      if (m.kind == gdb_message_kind::packet) {
+        sum += 1 + m.payload.size();
+      }
+    });
+  }
+  return sum;
+}
+
+size_t gdb_memory_baseline(std::string_view s) {
+  size_t sum{0};
+  size_t i{0};
+  while (i < s.size()) {
+    if (s[i] == '+') {
+      ++i;
+      continue;
+    }
+    if (s[i] != '$') {
+      return 0;
+    }
+    const size_t hash{s.find('#', i + 1)};
+    if (hash == std::string_view::npos || hash + 3 > s.size()) {
+      return 0;
+    }
+    unsigned checksum{0};
+    const auto r{std::from_chars(s.data() + hash + 1, s.data() + hash + 3,
+                                 checksum, 16)};
+    if (r.ptr != s.data() + hash + 3 ||
+        checksum != checksum_of(s.substr(i + 1, hash - i - 1))) {
+      return 0;
+    }
+    sum += hash - i;
+    i = hash + 3;
+  }
+  return sum;
+}
+
+// Decoding of memory transfers: the hex data of the memory read replies
+// above, and X packets that write 256 bytes of escaped binary data. The
+// checksum adds up the decoded bytes.
+
+const workload &gdb_hex_workload() { return gdb_memory_workload(); }
+
+size_t gdb_hex_apl(std::string_view s) {
+  size_t sum{0};
+  std::vector<uint8_t> memory;
+  gdb_stream stream;
+  const auto hex{gdb_hex_bytes(memory)};
+  stream.feed(s, [&sum, &memory, hex](const gdb_message &m) {
+    if (m.kind == gdb_message_kind::packet) {
+      str_pos pos{m.payload};
+      hex(pos);
+      sum = std::accumulate(memory.begin(), memory.end(), sum);
+    }
+  });
+  return sum;
+}
+
+size_t gdb_hex_baseline(std::string_view s) {
+  size_t sum{0};
+  size_t i{0};
+  while ((i = s.find('$', i)) != std::string_view::npos) {
+    const size_t hash{s.find('#', i)};
+    for (++i; i + 1 < hash; i += 2) {
+      unsigned b{0};
+      std::from_chars(s.data() + i, s.data() + i + 2, b, 16);
+      sum += b;
+    }
+  }
+  return sum;
+}
+
+const workload &gdb_binary_workload() {
+  static const workload w{[] {
+    static const char hex[]{"0123456789abcdef"};
+    std::string s;
+    const size_t packets{records / 20};
+    for (size_t i{0}; i < packets; ++i) {
+      std::string payload{"X7ffff7fe3290,100:"};
+      for (size_t b{0}; b < 256; ++b) {
+        const auto byte{static_cast<char>((i * 31 + b * 7) & 0xff)};
+        if (byte == '}' || byte == '#' || byte == '$' || byte == '*') {
+          payload += '}';
+          payload += static_cast<char>(byte ^ 0x20);
+        } else {
+          payload += byte;
+        }
+      }
+      const uint8_t checksum{checksum_of(payload)};
+      s += "$" + payload + "#" + hex[checksum >> 4] + hex[checksum & 0xf] +
+           "+";
+    }
+    return workload{s, packets};
+  }()};
+  return w;
+}
+
+size_t gdb_binary_apl(std::string_view s) {
+  size_t sum{0};
+  std::vector<uint8_t> memory;
+  gdb_stream stream;
+  const auto data{prefixed(many_view(noneOf(':')),
+                           prefixed(oneOf(':'), gdb_binary_bytes(memory)))};
+  stream.feed(s, [&sum, &memory, &data](const gdb_message &m) {
+    if (m.kind == gdb_message_kind::packet) {
+      str_pos pos{m.payload};
+      data(pos);
+      sum = std::accumulate(memory.begin(), memory.end(), sum);
+    }
+  });
+  return sum;
+}
+
+size_t gdb_binary_baseline(std::string_view s) {
+  size_t sum{0};
+  size_t i{0};
+  while ((i = s.find('$', i)) != std::string_view::npos) {
+    for (i = s.find(':', i) + 1; s[i] != '#'; ++i) {
+      sum += s[i] == '}' ? static_cast<uint8_t>(s[++i] ^ 0x20)
+                         : static_cast<uint8_t>(s[i]);
+    }
+  }
+  return sum;
+}
+
+// RFC 4180 CSV with CRLF line endings and some quoted fields, once narrow
+// and once wide. The checksum counts fields and their unescaped bytes.
+
+std::string csv_rfc_row(size_t i, size_t columns) {
+  std::string s;
+  for (size_t c{0}; c < columns; ++c) {
+    if (c) {
+      s += ',';
+    }
+    switch ((i + c) % 5) {
+    case 0:
+      s += std::to_string(i * columns + c);
+      break;
+    case 1:
+      s += "name_" + std::to_string(c);
+      break;
+    case 2:
+      s += std::to_string(c) + "." + std::to_string(i % 100);
+      break;
+    case 3:
+      s += "\"Smith, John\"";
+      break;
+    default:
+      s += "\"said \"\"hi\"\"\"";
+    }
+  }
+  return s + "\r\n";
+}
+
+workload csv_rfc_workload(size_t columns) {
+  std::string s;
+  const size_t rows{records * 4 / columns};
+  for (size_t i{0}; i < rows; ++i) {
+    s += csv_rfc_row(i, columns);
+  }
+  return {s, rows};
+}
+
+const workload &csv_narrow_workload() {
+  static const workload w{csv_rfc_workload(4)};
+  return w;
+}
+
+const workload &csv_wide_workload() {
+  static const workload w{csv_rfc_workload(64)};
+  return w;
+}
+
+size_t csv_rfc_apl(std::string_view s) {
+  size_t sum{0};
+  const bool ok{parse_csv(s, [&sum](const auto &fields) {
+    for (const auto field : fields) {
+      sum += 1 + field.size();
+    }
+  })};
+  return ok ? sum : 0;
+}
+
+size_t csv_rfc_baseline(std::string_view s) {
+  size_t sum{0};
+  size_t i{0};
+  while (i < s.size()) {
+    for (;;) {
+      size_t field_size{0};
+      if (s[i] == '"') {
+        for (++i;; ++i) {
+          if (i == s.size()) {
+            return 0;
+          }
+          if (s[i] == '"') {
+            if (i + 1 < s.size() && s[i + 1] == '"') {
+              ++i;
+            } else {
+              ++i;
+              break;
+            }
+          }
+          ++field_size;
+        }
+      } else {
+        while (i < s.size() && s[i] != ',' && s[i] != '\r' && s[i] != '\n') {
+          ++i;
+          ++field_size;
+        }
+      }
+      sum += 1 + field_size;
+      if (i < s.size() && s[i] == ',') {
+        ++i;
+        continue;
+      }
+      break;
+    }
+    if (i < s.size() && s[i] == '\r') {
+      ++i;
+    }
+    if (i < s.size() && s[i++] != '\n') {
+      return 0;
+    }
+  }
+  return sum;
+}
+
+size_t csv_narrow_apl(std::string_view s) { return csv_rfc_apl(s); }
+size_t csv_narrow_baseline(std::string_view s) { return csv_rfc_baseline(s); }
+size_t csv_wide_apl(std::string_view s) { return csv_rfc_apl(s); }
+size_t csv_wide_baseline(std::string_view s) { return csv_rfc_baseline(s); }
+
+} // namespace
+
+#define BENCH_THROUGHPUT(name)                                                 \
+  static void throughput_##name##_apl(benchmark::State &state) {               \
+    measure_throughput(state, name##_workload(), name##_apl);                  \
+  }                                                                            \
+  BENCHMARK(throughput_##name##_apl);                                          \
+  static void throughput_##name##_baseline(benchmark::State &state) {          \
+    if (name##_apl(name##_workload().input) !=                                 \
+        name##_baseline(name##_workload().input)) {                            \
+      state.SkipWithError("baseline and combinators disagree");                \
+      return;                                                                  \
+    }                                                                          \
+    measure_throughput(state, name##_workload(), name##_baseline);             \
+  }                                                                            \
+  BENCHMARK(throughput_##name##_baseline);
+
+BENCH_THROUGHPUT(csv)
+BENCH_THROUGHPUT(csv_narrow)
+BENCH_THROUGHPUT(csv_wide)
+BENCH_THROUGHPUT(log)
+BENCH_THROUGHPUT(gdb)
+BENCH_THROUGHPUT(gdb_memory)
+BENCH_THROUGHPUT(gdb_hex)
+BENCH_THROUGHPUT(gdb_binary)
+BENCH_THROUGHPUT(arithmetic)
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "parser.hpp"
+
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/*
+ * RFC 4180 CSV: fields are separated by a delimiter, rows end with CRLF or
+ * LF, and fields in double quotes may contain delimiters, line breaks and
+ * quotes written as "".
+ *
+ *   parse_csv(input, [](const std::vector<std::string_view> &fields) {
+ *     ...
+ *   });
+ *
+ * Fields are views into the input, except for quoted fields with "" escapes,
+ * which are unescaped into a buffer that is reused for the next row. The
+ * views are therefore only valid during the callback.
+ * Runs of plain field characters are skipped with the SIMD scan of noneOf().
+ * An empty line is a row with one empty field. A line break after the last
+ * row does not start another row.
+ */
+
+namespace apl {
+
+// Calls on_row with the fields of every row of input. Returns false if the
+// input is malformed (an unterminated quoted field or characters after the
+// closing quote), after on_row has seen the rows before the malformed one.
+template <typename F>
+static bool parse_csv(std::string_view input, F on_row,
+                      char delimiter = ',') {
+  const auto plain{many_view(noneOf(delimiter, '\n', '\r'))};
+  const auto quoted_chars{many_view(noneOf('"'))};
+  const auto separator{oneOf(delimiter)};
+  const auto row_end{choice(skip_string("\r\n"), skip_string("\n"))};
+
+  std::vector<std::string_view> fields;
+  std::string unescaped;
+  // Field index, offset and size in unescaped of every field with ""
+  // escapes.
+  std::vector<std::tuple<size_t, size_t, size_t>> escaped;
+
+  str_pos pos{input};
+  while (!pos.at_end()) {
+    fields.clear();
+    unescaped.clear();
+    escaped.clear();
+    do {
+      if (pos.at_end() || *pos != '"') {
+        fields.push_back(*plain(pos));
+        continue;
+      }
+      pos.next();
+      auto part{*quoted_chars(pos)};
+      if (pos.at_end()) {
+        return false;
+      }
+      pos.next();
+      if (pos.at_end() || *pos != '"') {
+        fields.push_back(part);
+        continue;
+      }
+      const size_t offset{unescaped.size()};
+      unescaped += part;
+      while (!pos.at_end() && *pos == '"') {
+        pos.next();
+        unescaped += '"';
+        unescaped += *quoted_chars(pos);
+        if (pos.at_end()) {
+          return false;
+        }
+        pos.next();
+      }
+      escaped.emplace_back(fields.size(), offset, unescaped.size() - offset);
+      fields.emplace_back();
+    } while (separator(pos));
+
+    if (!pos.at_end() && !row_end(pos)) {
+      return false;
+    }
+    for (const auto &[field, offset, size] : escaped) {
+      fields[field] = {unescaped.data() + offset, size};
+    }
+    on_row(std::as_const(fields));
+  }
+  return true;
+}
+
+} // namespace apl
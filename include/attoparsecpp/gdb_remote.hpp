@@ -0,0 +1,430 @@
+#pragma once
+
+#include "parser.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * GDB remote serial protocol framing: packets $payload#cc, where cc is the
+ * sum of the payload bytes modulo 256 in two hex digits, acknowledgements
+ * + and -, and the interrupt byte 0x03.
+ *
+ * gdb_message_parser parses one message from a complete buffer. gdb_stream
+ * parses messages from a byte stream that may be split anywhere and calls
+ * back for every complete message:
+ *
+ *   apl::gdb_stream stream;
+ *   stream.feed(bytes, [](const apl::gdb_message &m) { ... });
+ *
+ * The checksum is summed up while the payload is scanned for the closing #,
+ * so every payload byte is read once. Payloads are views of the input and
+ * still contain the protocol's } escapes and * run length encoding. A $
+ * within a payload, which senders have to escape, starts a new packet and
+ * drops the unfinished one.
+ *
+ * gdb_hex_bytes and gdb_binary_bytes decode the data of m replies and of X
+ * packets from a payload into a byte buffer:
+ *
+ *   std::vector<uint8_t> memory;
+ *   apl::parse_result(apl::gdb_hex_bytes(memory), payload);
+ */
+
+namespace apl {
+
+enum class gdb_message_kind {
+  ack,
+  nack,
+  interrupt,
+  packet,
+  bad_checksum,
+  // A packet that gdb_stream dropped because its payload was too long.
+  oversized
+};
+
+// Default payload limit of gdb_stream.
+inline constexpr size_t gdb_max_payload{16 * 1024};
+
+struct gdb_message {
+  gdb_message_kind kind;
+  // Payload of packet and bad_checksum messages.
+  std::string_view payload;
+
+  bool operator==(const gdb_message &o) const {
+    return kind == o.kind && payload == o.payload;
+  }
+};
+
+namespace detail {
+
+// Returns the first # or $ in [b, e), or e, and adds all bytes before it to
+// sum. Only the low byte of sum is exact, which is all a checksum needs.
+inline const char *scan_gdb_payload(const char *b, const char *e,
+                                    uint32_t &sum) {
+#ifdef __SSE2__
+  if (e - b >= 16) {
+    // The blocks are loaded as offsets c - '#'. As # and $ are adjacent, c
+    // is one of them iff its offset is at most 1, and the offsets add up to
+    // the sum of the bytes minus '#' per byte, modulo 256.
+    const __m128i hash{_mm_set1_epi8('#')};
+    const __m128i one{_mm_set1_epi8(1)};
+    const __m128i zero{_mm_setzero_si128()};
+    const auto load{[hash](const char *p) {
+      return _mm_sub_epi8(
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), hash);
+    }};
+    const auto stops{[one](__m128i offsets) {
+      return _mm_movemask_epi8(
+          _mm_cmpeq_epi8(_mm_min_epu8(offsets, one), offsets));
+    }};
+    __m128i acc{zero};
+    const char *const start{b};
+    // Four blocks per iteration share one branch on the search result.
+    for (; e - b >= 64; b += 64) {
+      const __m128i x0{load(b)};
+      const __m128i x1{load(b + 16)};
+      const __m128i x2{load(b + 32)};
+      const __m128i x3{load(b + 48)};
+      if (stops(_mm_min_epu8(_mm_min_epu8(x0, x1), _mm_min_epu8(x2, x3)))) {
+        break;
+      }
+      // Sums of absolute differences against zero add up 8 bytes each.
+      const __m128i lo{
+          _mm_add_epi64(_mm_sad_epu8(x0, zero), _mm_sad_epu8(x1, zero))};
+      const __m128i hi{
+          _mm_add_epi64(_mm_sad_epu8(x2, zero), _mm_sad_epu8(x3, zero))};
+      acc = _mm_add_epi64(acc, _mm_add_epi64(lo, hi));
+    }
+    for (; e - b >= 16; b += 16) {
+      const __m128i block{load(b)};
+      if (stops(block)) {
+        break;
+      }
+      acc = _mm_add_epi64(acc, _mm_sad_epu8(block, zero));
+    }
+    alignas(16) uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), acc);
+    sum += static_cast<uint32_t>(lanes[0] + lanes[1] +
+                                 static_cast<uint64_t>(b - start) * '#');
+  }
+#endif
+  while (b != e && *b != '#' && *b != '$') {
+    sum += static_cast<uint8_t>(*b++);
+  }
+  return b;
+}
+
+// Continues the scan of a packet whose payload starts at payload_begin and
+// whose payload bytes before pos sum up to sum. Fails if the packet is
+// incomplete, with pos at the end of the scanned payload, so the scan can
+// be resumed when there is more input, or if a $ interrupts it, with pos
+// at that $.
+// A checksum that does not match or that is no hex number makes the packet
+// a bad_checksum message.
+inline parser<gdb_message> finish_gdb_packet(const char *payload_begin,
+                                             str_pos &pos, uint32_t &sum) {
+  const std::string_view r{pos.remaining()};
+  pos.advance(static_cast<size_t>(
+      scan_gdb_payload(r.data(), r.data() + r.size(), sum) - r.data()));
+  if (pos.size() < 3 || *pos == '$') {
+    return {};
+  }
+  const char *const hash{pos.data()};
+  const std::string_view payload{payload_begin,
+                                 static_cast<size_t>(hash - payload_begin)};
+  const uint8_t hi{digit_values[static_cast<uint8_t>(hash[1])]};
+  const uint8_t lo{digit_values[static_cast<uint8_t>(hash[2])]};
+  pos.advance(3);
+  const bool valid{hi < 16 && lo < 16 &&
+                   (hi << 4 | lo) == static_cast<uint8_t>(sum)};
+  return {gdb_message{valid ? gdb_message_kind::packet
+                            : gdb_message_kind::bad_checksum,
+                      payload}};
+}
+
+#ifdef __SSE2__
+// Values of 16 hex digits, or false if one of them is no hex digit.
+inline bool hex_digit_values(__m128i block, __m128i &values) {
+  const __m128i decimal{_mm_sub_epi8(block, _mm_set1_epi8('0'))};
+  const __m128i is_decimal{
+      _mm_cmpeq_epi8(_mm_min_epu8(decimal, _mm_set1_epi8(9)), decimal)};
+  // Setting bit 5 maps upper case letters to lower case ones.
+  const __m128i letter{_mm_sub_epi8(_mm_or_si128(block, _mm_set1_epi8(0x20)),
+                                    _mm_set1_epi8('a'))};
+  const __m128i is_letter{
+      _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter)};
+  if (_mm_movemask_epi8(_mm_or_si128(is_decimal, is_letter)) != 0xffff) {
+    return false;
+  }
+  values = _mm_or_si128(
+      _mm_and_si128(is_decimal, decimal),
+      _mm_andnot_si128(is_decimal,
+                       _mm_add_epi8(letter, _mm_set1_epi8(10))));
+  return true;
+}
+
+// Combines the digit values of 8 hex pairs into 8 bytes, one per 16 bit
+// lane.
+inline __m128i hex_pair_bytes(__m128i values) {
+  const __m128i high{_mm_and_si128(values, _mm_set1_epi16(0xff))};
+  return _mm_or_si128(_mm_slli_epi16(high, 4), _mm_srli_epi16(values, 8));
+}
+#endif
+
+// Decodes hex digit pairs from [b, e) to out, up to the first character
+// that is no hex digit or a single digit at the end. Returns the end of the
+// decoded pairs.
+inline const char *decode_hex_pairs(const char *b, const char *e,
+                                    uint8_t *&out) {
+#ifdef __SSE2__
+  for (; e - b >= 32; b += 32, out += 16) {
+    __m128i lo;
+    __m128i hi;
+    if (!hex_digit_values(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(b)), lo) ||
+        !hex_digit_values(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + 16)), hi)) {
+      break;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out),
+                     _mm_packus_epi16(hex_pair_bytes(lo), hex_pair_bytes(hi)));
+  }
+#endif
+  for (; e - b >= 2; b += 2) {
+    const uint8_t hi{digit_values[static_cast<uint8_t>(b[0])]};
+    const uint8_t lo{digit_values[static_cast<uint8_t>(b[1])]};
+    if (hi >= 16 || lo >= 16) {
+      break;
+    }
+    *out++ = static_cast<uint8_t>(hi << 4 | lo);
+  }
+  return b;
+}
+
+// Copies [b, e) to out up to the first }, # or $ and returns its position.
+// Blocks of 16 bytes are stored before it is known where in them the run
+// ends, so out needs room for e - b bytes.
+inline const char *copy_gdb_binary_run(const char *b, const char *e,
+                                       uint8_t *&out) {
+#ifdef __SSE2__
+  const __m128i escape{_mm_set1_epi8('}')};
+  const __m128i hash{_mm_set1_epi8('#')};
+  const __m128i dollar{_mm_set1_epi8('$')};
+  for (; e - b >= 16; b += 16, out += 16) {
+    const __m128i block{_mm_loadu_si128(reinterpret_cast<const __m128i *>(b))};
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), block);
+    const auto stop{static_cast<uint32_t>(_mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(block, escape),
+                     _mm_or_si128(_mm_cmpeq_epi8(block, hash),
+                                  _mm_cmpeq_epi8(block, dollar)))))};
+    if (stop) {
+      const int n{__builtin_ctz(stop)};
+      out += n;
+      return b + n;
+    }
+  }
+#endif
+  for (; b != e && *b != '}' && *b != '#' && *b != '$'; ++b) {
+    *out++ = static_cast<uint8_t>(*b);
+  }
+  return b;
+}
+
+} // namespace detail
+
+// Parses one message. Fails on incomplete packets and on bytes that do not
+// start a message.
+inline parser<gdb_message> gdb_message_parser(str_pos &pos) {
+  if (pos.at_end()) {
+    return {};
+  }
+  switch (*pos) {
+  case '+':
+    pos.next();
+    return {gdb_message{gdb_message_kind::ack, {}}};
+  case '-':
+    pos.next();
+    return {gdb_message{gdb_message_kind::nack, {}}};
+  case '\x03':
+    pos.next();
+    return {gdb_message{gdb_message_kind::interrupt, {}}};
+  case '$': {
+    str_pos p{pos};
+    p.next();
+    uint32_t sum{0};
+    auto ret{detail::finish_gdb_packet(p.data(), p, sum)};
+    if (ret) {
+      pos = p;
+    }
+    return ret;
+  }
+  default:
+    return {};
+  }
+}
+
+// Decodes pairs of hex digits, like the data of m replies, into out and
+// returns the number of bytes. Decoding stops before the first character
+// that is no hex digit and before a single digit at the end.
+// out is overwritten, so one buffer can be reused for many payloads without
+// allocating again. Runs of 32 digits are decoded with SSE2.
+inline auto gdb_hex_bytes(std::vector<uint8_t> &out) {
+  return [&out](str_pos &pos) -> parser<size_t> {
+    const std::string_view r{pos.remaining()};
+    out.resize(r.size() / 2);
+    uint8_t *o{out.data()};
+    pos.advance(static_cast<size_t>(
+        detail::decode_hex_pairs(r.data(), r.data() + r.size(), o) -
+        r.data()));
+    out.resize(static_cast<size_t>(o - out.data()));
+    return {out.size()};
+  };
+}
+
+// Decodes binary data with } escapes (the next byte XOR 0x20), like the
+// data of X packets, into out and returns the number of bytes. Decoding
+// stops before an unescaped # or $. Fails without consuming input if the
+// data ends within an escape sequence.
+// out is overwritten like by gdb_hex_bytes. Runs without escapes are
+// copied 16 bytes at a time with SSE2.
+inline auto gdb_binary_bytes(std::vector<uint8_t> &out) {
+  return [&out](str_pos &pos) -> parser<size_t> {
+    const char *const b{pos.data()};
+    const char *const e{b + pos.size()};
+    out.resize(pos.size());
+    uint8_t *o{out.data()};
+    const char *it{b};
+    for (;;) {
+      it = detail::copy_gdb_binary_run(it, e, o);
+      if (it == e || *it != '}') {
+        break;
+      }
+      if (e - it < 2) {
+        out.clear();
+        return {};
+      }
+      *o++ = static_cast<uint8_t>(it[1] ^ 0x20);
+      it += 2;
+    }
+    out.resize(static_cast<size_t>(o - out.data()));
+    pos.advance(static_cast<size_t>(it - b));
+    return {out.size()};
+  };
+}
+
+// Splits a byte stream into messages. Bytes outside of messages are
+// skipped, like GDB stubs do to resynchronize after line noise.
+// Messages that lie completely within a chunk are handed out as views into
+// that chunk. Only a packet that is split across chunks is copied into an
+// internal buffer, up to its end, and its scan continues where the previous
+// chunk ended. The views are only valid during the callback.
+// Packets with more than max_payload payload bytes are not buffered but
+// reported as oversized messages, so line noise or a misbehaving peer
+// cannot make the buffer grow without bound.
+class gdb_stream {
+  size_t max_payload;
+  // The pending packet from its $ on. Its payload is left out once it is
+  // known to be oversized.
+  std::string pending;
+  // Number of payload bytes of the pending packet that are already scanned,
+  // and their sum.
+  size_t scanned{0};
+  uint32_t sum{0};
+  bool oversized{false};
+
+  template <typename F> void parse_chunk(str_pos pos, F &on_message) {
+    const auto garbage{skip_many(noneOf('$', '+', '-', '\x03'))};
+    while (garbage(pos), !pos.at_end()) {
+      if (*pos != '$') {
+        on_message(*gdb_message_parser(pos));
+        continue;
+      }
+      const char *const begin{pos.data()};
+      pos.next();
+      sum = 0;
+      if (const auto msg{detail::finish_gdb_packet(begin + 1, pos, sum)}) {
+        on_message(msg->payload.size() > max_payload
+                       ? gdb_message{gdb_message_kind::oversized, {}}
+                       : *msg);
+        continue;
+      }
+      if (!pos.at_end() && *pos == '$') {
+        continue;
+      }
+      keep_pending(begin, pos);
+      return;
+    }
+  }
+
+  // Buffers the incomplete packet that starts at begin and whose payload is
+  // scanned up to pos.
+  void keep_pending(const char *begin, str_pos pos) {
+    const std::string_view rest{pos.remaining()};
+    scanned = static_cast<size_t>(rest.data() - begin) - 1;
+    oversized = scanned > max_payload;
+    pending.assign(begin, oversized ? begin + 1 : rest.data());
+    pending.append(rest);
+  }
+
+  // Continues the pending packet with chunk and sets used to the number of
+  // bytes of chunk that belong to it. Returns the message if the packet is
+  // complete, which the caller has to clear afterwards. A $ in chunk drops
+  // the packet, and used stops before that $.
+  parser<gdb_message> resume_pending(std::string_view chunk, size_t &used) {
+    // The rest of the packet is scanned within chunk, and only the part of
+    // chunk up to the end of the packet is copied.
+    const char *const b{chunk.data()};
+    const char *const e{b + chunk.size()};
+    const size_t tail{pending.size() - 1 - (oversized ? 0 : scanned)};
+    const char *stop{b};
+    if (tail == 0) {
+      stop = detail::scan_gdb_payload(b, e, sum);
+      scanned += static_cast<size_t>(stop - b);
+      if (stop != e && *stop == '$') {
+        used = static_cast<size_t>(stop - b);
+        pending.clear();
+        return {};
+      }
+      if (!oversized && scanned > max_payload) {
+        oversized = true;
+        pending.resize(1);
+      }
+    }
+    used = std::min(static_cast<size_t>(stop - b) + 3 - tail, chunk.size());
+    pending.append(oversized ? stop : b, b + used);
+    str_pos pos{pending};
+    pos.advance(1 + (oversized ? 0 : scanned));
+    if (pos.size() < 3) {
+      return {};
+    }
+    if (oversized) {
+      return {gdb_message{gdb_message_kind::oversized, {}}};
+    }
+    return detail::finish_gdb_packet(pending.data() + 1, pos, sum);
+  }
+
+public:
+  explicit gdb_stream(size_t limit = gdb_max_payload) : max_payload{limit} {}
+
+  // Parses chunk, the next bytes of the stream, and calls on_message with
+  // every message that it completes.
+  template <typename F> void feed(std::string_view chunk, F on_message) {
+    if (!pending.empty()) {
+      size_t used{0};
+      if (const auto msg{resume_pending(chunk, used)}) {
+        on_message(*msg);
+        pending.clear();
+      }
+      chunk.remove_prefix(used);
+    }
+    parse_chunk(chunk, on_message);
+  }
+
+  // True if the bytes fed so far end within a packet.
+  bool partial() const { return !pending.empty(); }
+};
+
+} // namespace apl
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "parser.hpp"
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+/*
+ * Incremental parsing of input that arrives in chunks, e.g. from pipes or
+ * sockets, in the spirit of attoparsec's Partial results:
+ *
+ *   incremental<Parser> runs one parser. feed(chunk) returns partial as long
+ *   as the parser needs more input, and finish() signals the end of input.
+ *
+ *   incremental_items<Parser, F> runs an item parser over and over and hands
+ *   every complete item to a callback. Input that belongs to complete items
+ *   is dropped and not parsed again.
+ *
+ * A parse that fails or that consumes all buffered input could turn out
+ * differently with more input, so it stays partial until the next chunk or
+ * finish(). A parse that succeeds before the end of the buffered input is
+ * done right away. Parsers that rewind after looking past their end
+ * (attempt()) may therefore complete early.
+ *
+ * The combinators cannot suspend in the middle of a parse, so every feed()
+ * parses the pending input again from its start. Feeding one message in k
+ * chunks therefore costs k parses of up to the whole message. Long streams
+ * are better split into items, where only the unfinished item is parsed
+ * again. An unfinished item longer than max_item bytes fails the stream, so
+ * malformed input cannot make the buffer, or the cost of parsing it again,
+ * grow without bound.
+ */
+
+namespace apl {
+
+enum class incremental_status { partial, done, failed };
+
+// Default size limit of an unfinished item of incremental_items.
+inline constexpr size_t incremental_max_item{64 * 1024};
+
+namespace detail {
+
+// Input that has been fed but not consumed yet. The consumed prefix is
+// dropped lazily, so that appending stays amortized linear.
+class input_buffer {
+  std::string data;
+  size_t begin{0};
+
+public:
+  void append(std::string_view chunk) {
+    if (begin > data.size() / 2) {
+      data.erase(0, begin);
+      begin = 0;
+    }
+    data.append(chunk);
+  }
+
+  str_pos pos() const {
+    return {data.data() + begin, data.data() + data.size()};
+  }
+
+  void consume_to(const str_pos &pos) {
+    begin = static_cast<size_t>(pos.data() - data.data());
+  }
+
+  std::string_view view() const {
+    return std::string_view{data}.substr(begin);
+  }
+
+  size_t size() const { return data.size() - begin; }
+};
+
+} // namespace detail
+
+template <typename Parser> class incremental {
+  Parser p;
+  detail::input_buffer input;
+  parser_ret<Parser> value;
+  incremental_status state{incremental_status::partial};
+  bool at_eof{false};
+
+  incremental_status run() {
+    str_pos pos{input.pos()};
+    auto ret{p(pos)};
+    if (ret && (at_eof || !pos.at_end())) {
+      value = std::move(ret);
+      input.consume_to(pos);
+      state = incremental_status::done;
+    } else if (at_eof) {
+      state = incremental_status::failed;
+    }
+    return state;
+  }
+
+public:
+  explicit incremental(Parser parser) : p{std::move(parser)} {}
+
+  incremental_status feed(std::string_view chunk) {
+    if (state != incremental_status::partial) {
+      return state;
+    }
+    input.append(chunk);
+    return run();
+  }
+
+  incremental_status finish() {
+    if (state != incremental_status::partial) {
+      return state;
+    }
+    at_eof = true;
+    return run();
+  }
+
+  incremental_status status() const { return state; }
+
+  // The parse result once the status is done.
+  const parser_ret<Parser> &result() const { return value; }
+
+  // Input that follows the parsed part once the status is done.
+  std::string_view rest() const { return input.view(); }
+};
+
+// Parses a stream of items and calls on_item with each complete one.
+// Views in the items point into the internal buffer and are only valid
+// during the callback.
+// Set complete_at_end if the item parser ends with a terminator (like a
+// newline), so an item that ends exactly at the end of the buffered input is
+// complete without waiting for more input.
+template <typename Parser, typename F> class incremental_items {
+  Parser p;
+  F on_item;
+  bool complete_at_end;
+  size_t max_item;
+  detail::input_buffer input;
+  incremental_status state{incremental_status::partial};
+
+  incremental_status run(bool at_eof) {
+    while (input.size()) {
+      str_pos pos{input.pos()};
+      auto ret{p(pos)};
+      const bool consumed{pos.size() < input.size()};
+      if (!ret || !consumed) {
+        // An item that consumes nothing would repeat forever. A failed one
+        // may still be the beginning of an item that is split across chunks.
+        if (at_eof || (ret && !consumed) || input.size() > max_item) {
+          state = incremental_status::failed;
+        }
+        return state;
+      }
+      if (pos.at_end() && !at_eof && !complete_at_end) {
+        if (input.size() > max_item) {
+          state = incremental_status::failed;
+        }
+        return state;
+      }
+      on_item(std::move(*ret));
+      input.consume_to(pos);
+    }
+    if (at_eof) {
+      state = incremental_status::done;
+    }
+    return state;
+  }
+
+public:
+  incremental_items(Parser parser, F f, bool complete_at_end = false,
+                    size_t max_item = incremental_max_item)
+      : p{std::move(parser)}, on_item{std::move(f)},
+        complete_at_end{complete_at_end}, max_item{max_item} {}
+
+  incremental_status feed(std::string_view chunk) {
+    if (state != incremental_status::partial) {
+      return state;
+    }
+    input.append(chunk);
+    return run(false);
+  }
+
+  incremental_status finish() {
+    if (state != incremental_status::partial) {
+      return state;
+    }
+    return run(true);
+  }
+
+  incremental_status status() const { return state; }
+
+  // Input that has not been parsed into complete items yet.
+  std::string_view rest() const { return input.view(); }
+};
+
+} // namespace apl
@@ -0,0 +1,384 @@
+#pragma once
+
+#include "parser.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/*
+ * Event based (SAX style) JSON parser. Instead of building a document tree,
+ * json_grammar reports every value to a handler while it parses:
+ *
+ *   struct handler : apl::json_handler {
+ *     void integer(int64_t i) { sum += i; }
+ *     int64_t sum{0};
+ *   };
+ *
+ *   handler h;
+ *   bool ok{apl::parse_json(input, h)};
+ *
+ * parse_json() reuses one grammar per handler type and thread, so a handler
+ * must not call parse_json() for its own type from within an event.
+ * Arrays and objects nest at most json_max_depth levels deep, deeper input
+ * is rejected instead of exhausting the stack.
+ *
+ * Strings without escape sequences are passed as views into the input.
+ * Strings with escapes are decoded into a buffer that is reused for the next
+ * string, so the views handed to the handler are only valid during the call.
+ * Numbers without fraction and exponent that fit into int64_t are reported
+ * as integer(), all others as number().
+ */
+
+namespace apl {
+
+// No-op handler to derive from, so handlers only implement the events they
+// are interested in.
+struct json_handler {
+  void null() {}
+  void boolean(bool) {}
+  void integer(int64_t) {}
+  void number(double) {}
+  void string(std::string_view) {}
+  void key(std::string_view) {}
+  void start_object() {}
+  void end_object() {}
+  void start_array() {}
+  void end_array() {}
+};
+
+inline constexpr char_class json_space_class{chars<' ', '\t', '\n', '\r'>};
+
+inline constexpr size_t json_max_depth{512};
+
+namespace detail {
+
+// Appends code point cp as UTF-8.
+inline void append_utf8(std::string &out, uint32_t cp) {
+  if (cp < 0x80) {
+    out += static_cast<char>(cp);
+  } else if (cp < 0x800) {
+    out += static_cast<char>(0xc0 | (cp >> 6));
+    out += static_cast<char>(0x80 | (cp & 0x3f));
+  } else if (cp < 0x10000) {
+    out += static_cast<char>(0xe0 | (cp >> 12));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (cp & 0x3f));
+  } else {
+    out += static_cast<char>(0xf0 | (cp >> 18));
+    out += static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (cp & 0x3f));
+  }
+}
+
+// Consumes the characters of a string that need no special treatment, which
+// stops at quotes, backslashes and the control characters that JSON strings
+// must not contain.
+struct json_plain_chars {
+  static constexpr bool plain(char c) {
+    return static_cast<unsigned char>(c) >= 0x20 && c != '"' && c != '\\';
+  }
+
+  parser<char> operator()(str_pos &p) const {
+    if (!p.at_end() && plain(*p)) {
+      return {p.consume()};
+    }
+    return {};
+  }
+
+  const char *scan(const char *b, const char *e) const {
+#ifdef __SSE2__
+    const __m128i quote{_mm_set1_epi8('"')};
+    const __m128i backslash{_mm_set1_epi8('\\')};
+    const __m128i last_control{_mm_set1_epi8(0x1f)};
+    for (; e - b >= 16; b += 16) {
+      const __m128i block{
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(b))};
+      // c <= 0x1f (unsigned) iff min(c, 0x1f) == c.
+      const __m128i control{
+          _mm_cmpeq_epi8(_mm_min_epu8(block, last_control), block)};
+      const __m128i stop{_mm_or_si128(
+          control, _mm_or_si128(_mm_cmpeq_epi8(block, quote),
+                                _mm_cmpeq_epi8(block, backslash)))};
+      if (const auto mask{static_cast<uint32_t>(_mm_movemask_epi8(stop))}) {
+        return b + __builtin_ctz(mask);
+      }
+    }
+#endif
+    while (b != e && plain(*b)) {
+      ++b;
+    }
+    return b;
+  }
+};
+
+// Parses the XXXX of a \uXXXX escape.
+inline parser<uint32_t> json_hex4(str_pos &pos) {
+  const size_t before{pos.size()};
+  auto ret{base_integer<uint32_t>(16, 4)(pos)};
+  if (before - pos.size() != 4) {
+    return {};
+  }
+  return ret;
+}
+
+// Decodes the escape sequence after a backslash and appends it to out.
+inline bool append_json_escape(str_pos &pos, std::string &out) {
+  if (pos.at_end()) {
+    return false;
+  }
+  switch (pos.consume()) {
+  case '"':
+    out += '"';
+    return true;
+  case '\\':
+    out += '\\';
+    return true;
+  case '/':
+    out += '/';
+    return true;
+  case 'b':
+    out += '\b';
+    return true;
+  case 'f':
+    out += '\f';
+    return true;
+  case 'n':
+    out += '\n';
+    return true;
+  case 'r':
+    out += '\r';
+    return true;
+  case 't':
+    out += '\t';
+    return true;
+  case 'u':
+    break;
+  default:
+    return false;
+  }
+
+  auto cp{json_hex4(pos)};
+  if (!cp || (0xdc00 <= *cp && *cp < 0xe000)) {
+    return false;
+  }
+  if (0xd800 <= *cp && *cp < 0xdc00) {
+    const auto low{prefixed(skip_string("\\u"), json_hex4)(pos)};
+    if (!low || *low < 0xdc00 || 0xe000 <= *low) {
+      return false;
+    }
+    *cp = 0x10000 + ((*cp - 0xd800) << 10) + (*low - 0xdc00);
+  }
+  append_utf8(out, *cp);
+  return true;
+}
+
+} // namespace detail
+
+// The rules of a JSON parser. A grammar is built once and then parses any
+// number of documents, each reporting to the handler passed to parse().
+// The rules refer to each other and to the grammar's decoding buffer, so
+// a grammar can be neither copied nor moved.
+template <typename Handler> class json_grammar {
+  Handler *handler{nullptr};
+  std::string unescaped;
+  // Number of arrays and objects that enclose the current value.
+  size_t depth{0};
+
+  // One value with optional whitespace around it.
+  rule<unit> value;
+  // A value followed by the end of the input.
+  rule<unit> document;
+
+public:
+  json_grammar() {
+    const auto ws{skip_while(json_space_class)};
+
+    const auto plain_chars{many_view(detail::json_plain_chars{})};
+    const auto quoted{[this, plain_chars](str_pos &pos)
+                          -> parser<std::string_view> {
+      if (pos.at_end() || *pos != '"') {
+        return {};
+      }
+      pos.next();
+      const auto plain{plain_chars(pos)};
+      if (pos.at_end()) {
+        return {};
+      }
+      char stop{pos.consume()};
+      if (stop == '"') {
+        return plain;
+      }
+      unescaped.assign(plain->data(), plain->size());
+      for (; stop != '"'; stop = pos.consume()) {
+        // Anything but a backslash here is a control character.
+        if (stop != '\\' || !detail::append_json_escape(pos, unescaped)) {
+          return {};
+        }
+        unescaped += *plain_chars(pos);
+        if (pos.at_end()) {
+          return {};
+        }
+      }
+      return {unescaped};
+    }};
+
+    const auto int64{base_integer<int64_t>(10)};
+    const auto number{[this, int64](str_pos &pos) -> parser<unit> {
+      const char *const b{pos.data()};
+      const char *const e{b + pos.size()};
+      const char *it{b};
+      const bool negative{it != e && *it == '-'};
+      it += negative;
+      if (it == e || !digit_class(*it)) {
+        return {};
+      }
+      it = *it == '0' ? it + 1 : detail::skip_digits(it, e);
+      bool integral{true};
+      if (it != e && *it == '.') {
+        const char *fraction_end{detail::skip_digits(it + 1, e)};
+        if (fraction_end == it + 1) {
+          return {};
+        }
+        integral = false;
+        it = fraction_end;
+      }
+      if (it != e && (*it == 'e' || *it == 'E')) {
+        ++it;
+        if (it != e && (*it == '+' || *it == '-')) {
+          ++it;
+        }
+        const char *exponent_end{detail::skip_digits(it, e)};
+        if (exponent_end == it) {
+          return {};
+        }
+        integral = false;
+        it = exponent_end;
+      }
+      if (integral) {
+        str_pos digits{b + negative, it};
+        if (const auto i{int64(digits)}) {
+          handler->integer(negative ? -*i : *i);
+          pos.advance(static_cast<size_t>(it - b));
+          return {unit{}};
+        }
+      }
+      double d{0.0};
+      if (!detail::convert_float(b, it, d)) {
+        return {};
+      }
+      handler->number(d);
+      pos.advance(static_cast<size_t>(it - b));
+      return {unit{}};
+    }};
+
+    const auto comma{postfixed(ws, oneOf(','))};
+
+    const auto array{[this, ws, comma](str_pos &pos) -> parser<unit> {
+      if (!oneOf('[')(pos) || ++depth > json_max_depth) {
+        return {};
+      }
+      handler->start_array();
+      ws(pos);
+      if (!oneOf(']')(pos)) {
+        do {
+          if (!value(pos)) {
+            return {};
+          }
+        } while (comma(pos));
+        if (!oneOf(']')(pos)) {
+          return {};
+        }
+      }
+      handler->end_array();
+      --depth;
+      return {unit{}};
+    }};
+
+    const auto member{[this, ws, quoted](str_pos &pos) -> parser<unit> {
+      const auto k{quoted(pos)};
+      if (!k) {
+        return {};
+      }
+      handler->key(*k);
+      ws(pos);
+      if (!oneOf(':')(pos)) {
+        return {};
+      }
+      return value(pos);
+    }};
+
+    const auto object{[this, ws, comma, member](str_pos &pos) -> parser<unit> {
+      if (!oneOf('{')(pos) || ++depth > json_max_depth) {
+        return {};
+      }
+      handler->start_object();
+      ws(pos);
+      if (!oneOf('}')(pos)) {
+        do {
+          if (!member(pos)) {
+            return {};
+          }
+        } while (comma(pos));
+        if (!oneOf('}')(pos)) {
+          return {};
+        }
+      }
+      handler->end_object();
+      --depth;
+      return {unit{}};
+    }};
+
+    const auto literal{[this](std::string_view s, auto event) {
+      return with_first_set(char_class{}.add(s.front()),
+                            map(skip_string(s), [this, event](unit) {
+                              event(*handler);
+                              return unit{};
+                            }));
+    }};
+
+    value = clasped(
+        ws, ws,
+        choice_first(with_first_set(chars<'{'>, object),
+                     with_first_set(chars<'['>, array),
+                     with_first_set(chars<'"'>,
+                                    map(quoted,
+                                        [this](std::string_view s) {
+                                          handler->string(s);
+                                          return unit{};
+                                        })),
+                     with_first_set(digit_class | chars<'-'>, number),
+                     literal("true", [](Handler &h) { h.boolean(true); }),
+                     literal("false", [](Handler &h) { h.boolean(false); }),
+                     literal("null", [](Handler &h) { h.null(); })));
+
+    document = [this](str_pos &pos) -> parser<unit> {
+      if (!value(pos) || !pos.at_end()) {
+        return {};
+      }
+      return {unit{}};
+    };
+  }
+
+  json_grammar(const json_grammar &) = delete;
+  json_grammar &operator=(const json_grammar &) = delete;
+
+  // Parses input as one JSON document and reports its values to h.
+  bool parse(std::string_view input, Handler &h) {
+    handler = &h;
+    depth = 0;
+    return !!parse_result(document, input);
+  }
+};
+
+// Parses input as one JSON document and reports its values to handler.
+// Returns false if the input is no valid JSON. The handler may already have
+// seen events of the valid beginning of the input then.
+template <typename Handler>
+static bool parse_json(std::string_view input, Handler &handler) {
+  static thread_local json_grammar<Handler> grammar;
+  return grammar.parse(input, handler);
+}
+
+} // namespace apl
@@ -12,10 +12,18 @@
  *
  * add_op = (char '+' *> pure (+)) <|> (char '-' *> pure (-))
  * mul_op = (char '*' *> pure (*)) <|> (char '/' *> pure (/))
+ *
+ * expr and term are parsed by expression() over factor with one precedence
+ * level per chainl1. Their operators yield the operator character instead of
+ * add_op/mul_op's function pointers, so no indirect call is made. add_op and
+ * mul_op remain for existing users. The three parsers are rules, so factor
+ * can refer to expr.
  */
 
 namespace apl {
 
+static parser<int (*)(int, int)> add_op(str_pos &p) __attribute__((unused));
+
 static parser<int (*)(int, int)> add_op(str_pos &p) {
   if (p.at_end()) {
     return {};
@@ -33,6 +41,8 @@ static parser<int (*)(int, int)> add_op(str_pos &p) {
   }
 }
 
+static parser<int (*)(int, int)> mul_op(str_pos &p) __attribute__((unused));
+
 static parser<int (*)(int, int)> mul_op(str_pos &p) {
   if (p.at_end()) {
     return {};
@@ -50,20 +60,53 @@ static parser<int (*)(int, int)> mul_op(str_pos &p) {
   }
 }
 
-static parser<int> expr(str_pos &p);
-static parser<int> term(str_pos &p);
-static parser<int> factor(str_pos &p);
+static int apply_arith_op(char op, int a, int b) {
+  switch (op) {
+  case '+':
+    return a + b;
+  case '-':
+    return a - b;
+  case '*':
+    return a * b;
+  default:
+    return a / b;
+  }
+}
 
-static parser<int> expr(str_pos &p) {
-  return chainl1(token(term), token(add_op))(p);
-};
+// Built once, when one of expr, term and factor is first used. Only the
+// parenthesized subexpressions of factor go through the rule's indirect
+// call.
+struct math_grammar {
+  rule<int> expr;
+  rule<int> term;
+  rule<int> factor;
 
-static parser<int> term(str_pos &p) {
-  return chainl1(token(factor), token(mul_op))(p);
+  math_grammar() {
+    const auto factor_p{
+        choice(base_integer(10), clasped(oneOf('('), oneOf(')'), expr))};
+    const auto mul_level{infix_left(token(oneOf('*', '/')), apply_arith_op)};
+    factor = factor_p;
+    term = expression(token(factor_p), operator_table(mul_level));
+    expr = expression(
+        token(factor_p),
+        operator_table(infix_left(token(oneOf('+', '-')), apply_arith_op),
+                       mul_level));
+  }
 };
 
-static parser<int> factor(str_pos &p) {
-  return choice(base_integer(10), clasped(oneOf('('), oneOf(')'), expr))(p);
+static const math_grammar &math_rules() {
+  static const math_grammar grammar;
+  return grammar;
 }
 
+static parser<int> expr(str_pos &p) { return math_rules().expr(p); }
+
+static parser<int> term(str_pos &p) __attribute__((unused));
+
+static parser<int> term(str_pos &p) { return math_rules().term(p); }
+
+static parser<int> factor(str_pos &p) __attribute__((unused));
+
+static parser<int> factor(str_pos &p) { return math_rules().factor(p); }
+
 } // namespace apl
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "parser.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/*
+ * Packrat parsing: memo(rule) caches the outcome of a rule at every input
+ * position it has been tried at, so backtracking grammars (choice() over
+ * attempt()s that share prefixes) run in linear instead of exponential time.
+ *
+ * The cache lives in a memo_table that is activated for the current thread
+ * by a memo_scope or the parse_result/run_parser overloads below.
+ * Without an active table, memo(rule) just runs rule.
+ * Left recursive rules are not supported, just like in any packrat parser.
+ */
+
+namespace apl {
+
+// Flat open addressing map from (rule id, input position) to the result and
+// end position of that rule at that position.
+// clear() forgets all entries in O(1) and keeps the allocated memory, so a
+// single table can be reused for many parses.
+class memo_table {
+  struct slot {
+    const char *pos;
+    const char *end;
+    uint32_t rule;
+    uint32_t value;
+    uint32_t generation;
+  };
+
+  struct value_pool_base {
+    virtual ~value_pool_base() = default;
+    virtual void clear() = 0;
+  };
+
+  template <typename T> struct value_pool : value_pool_base {
+    std::vector<parser<T>> values;
+    void clear() override { values.clear(); }
+  };
+
+  // Slots of older generations count as empty.
+  std::vector<slot> slots;
+  size_t used{0};
+  uint32_t generation{1};
+  // Result values, one typed pool per rule id.
+  std::vector<std::unique_ptr<value_pool_base>> pools;
+
+  static size_t hash(const char *pos, uint32_t rule) {
+    auto h{static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pos)) *
+               0x9e3779b97f4a7c15ull ^
+           rule * 0xc2b2ae3d27d4eb4full};
+    return static_cast<size_t>(h ^ (h >> 29));
+  }
+
+  // Returns the slot of (pos, rule), or the empty slot it would go into.
+  slot &find_slot(const char *pos, uint32_t rule) {
+    const size_t mask{slots.size() - 1};
+    for (size_t i{hash(pos, rule) & mask};; i = (i + 1) & mask) {
+      slot &s{slots[i]};
+      if (s.generation != generation || (s.pos == pos && s.rule == rule)) {
+        return s;
+      }
+    }
+  }
+
+  void grow() {
+    std::vector<slot> old(std::max<size_t>(64, slots.size() * 2));
+    old.swap(slots);
+    for (const slot &s : old) {
+      if (s.generation == generation) {
+        find_slot(s.pos, s.rule) = s;
+      }
+    }
+  }
+
+  template <typename T> value_pool<T> &pool(uint32_t rule) {
+    if (pools.size() <= rule) {
+      pools.resize(rule + 1);
+    }
+    if (!pools[rule]) {
+      pools[rule] = std::make_unique<value_pool<T>>();
+    }
+    return static_cast<value_pool<T> &>(*pools[rule]);
+  }
+
+public:
+  void clear() {
+    used = 0;
+    if (++generation == 0) {
+      for (slot &s : slots) {
+        s.generation = 0;
+      }
+      generation = 1;
+    }
+    for (auto &p : pools) {
+      if (p) {
+        p->clear();
+      }
+    }
+  }
+
+  // Returns the cached result of rule at pos and sets end to where the rule
+  // stopped, or returns nullptr if rule has not been tried at pos yet.
+  // The pointer is valid until the next insert().
+  template <typename T>
+  const parser<T> *find(uint32_t rule, const char *pos, const char *&end) {
+    if (slots.empty()) {
+      return nullptr;
+    }
+    const slot &s{find_slot(pos, rule)};
+    if (s.generation != generation) {
+      return nullptr;
+    }
+    end = s.end;
+    return &pool<T>(rule).values[s.value];
+  }
+
+  template <typename T>
+  void insert(uint32_t rule, const char *pos, const char *end,
+              parser<T> value) {
+    if (2 * (used + 1) > slots.size()) {
+      grow();
+    }
+    auto &values{pool<T>(rule).values};
+    slot &s{find_slot(pos, rule)};
+    if (s.generation != generation) {
+      ++used;
+    }
+    s = slot{pos, end, rule, static_cast<uint32_t>(values.size()),
+             generation};
+    values.push_back(std::move(value));
+  }
+};
+
+namespace detail {
+
+inline std::atomic<uint32_t> next_memo_rule{0};
+inline thread_local memo_table *active_memo_table{nullptr};
+
+} // namespace detail
+
+// Clears table and makes it the memo table of all memo() rules that run on
+// this thread during the lifetime of the scope.
+class memo_scope {
+  memo_table *previous;
+
+public:
+  explicit memo_scope(memo_table &table)
+      : previous{detail::active_memo_table} {
+    table.clear();
+    detail::active_memo_table = &table;
+  }
+  ~memo_scope() { detail::active_memo_table = previous; }
+
+  memo_scope(const memo_scope &) = delete;
+  memo_scope &operator=(const memo_scope &) = delete;
+};
+
+// Every call creates a new rule id, so build memo parsers once (e.g. as
+// static variables) instead of inside the functions that use them.
+template <typename Parser> static auto memo(Parser p) {
+  using T = parser_payload_type<Parser>;
+  const uint32_t rule{detail::next_memo_rule++};
+  return [p, rule](str_pos &pos) -> parser<T> {
+    memo_table *table{detail::active_memo_table};
+    if (!table) {
+      return p(pos);
+    }
+    const char *end;
+    const char *start{pos.data()};
+    if (const auto *ret{table->find<T>(rule, start, end)}) {
+      pos.advance(static_cast<size_t>(end - start));
+      return *ret;
+    }
+    auto ret{p(pos)};
+    table->insert<T>(rule, start, pos.data(), ret);
+    return ret;
+  };
+}
+
+template <typename Parser>
+static auto run_parser(Parser &&p, str_pos pos, memo_table &table)
+    -> std::pair<parser_ret<Parser>, str_pos> {
+  const memo_scope scope{table};
+  return {p(pos), pos};
+}
+
+template <typename Parser>
+static auto parse_result(Parser &&p, str_pos pos,
+                         memo_table &table) -> parser_ret<Parser> {
+  const memo_scope scope{table};
+  return p(pos);
+}
+
+} // namespace apl
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "parser.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/*
+ * Parallel parsing of record delimited input, e.g. newline separated log or
+ * CSV files, where every record is parsed on its own by the same parser.
+ *
+ * The buffer is cut into many more chunks than there are threads, and every
+ * chunk boundary is moved forward to the next delimiter. The threads claim
+ * chunks one after another from a shared counter, so a thread that got
+ * cheap records simply takes more chunks.
+ * The parser is shared by all threads and must be safe to call concurrently,
+ * which all stateless combinators are.
+ */
+
+namespace apl {
+
+template <typename T> struct parallel_records {
+  // One result per record, in input order.
+  std::vector<parser<T>> results;
+  // Indices of the records that the parser rejected, ascending.
+  std::vector<size_t> failures;
+};
+
+namespace detail {
+
+// Returns the position after the next delimiter at or behind p.
+inline const char *next_record(const char *p, const char *end, char delim) {
+  const auto *d{static_cast<const char *>(
+      std::memchr(p, delim, static_cast<size_t>(end - p)))};
+  return d ? d + 1 : end;
+}
+
+} // namespace detail
+
+// Parses every record of buffer that ends with delimiter (the last one may
+// lack it) with p, using n_threads threads including the calling one.
+// A record is handed to p without its delimiter, and p has to consume all
+// of it. Records with trailing input count as failures.
+template <typename Parser>
+static auto parallel_parse_records(const Parser &p, std::string_view buffer,
+                                   char delimiter = '\n',
+                                   size_t n_threads = 0)
+    -> parallel_records<parser_payload_type<Parser>> {
+  using T = parser_payload_type<Parser>;
+
+  if (n_threads == 0) {
+    n_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  const char *const begin{buffer.data()};
+  const char *const end{begin + buffer.size()};
+
+  constexpr size_t min_chunk_size{16 * 1024};
+  const size_t n_chunks{std::max<size_t>(
+      1, std::min(n_threads * 16, buffer.size() / min_chunk_size))};
+  const size_t chunk_size{buffer.size() / n_chunks};
+
+  std::vector<const char *> bounds;
+  bounds.reserve(n_chunks + 1);
+  bounds.push_back(begin);
+  for (size_t i{1}; i < n_chunks; ++i) {
+    const char *b{std::max(begin + i * chunk_size, bounds.back())};
+    bounds.push_back(b == begin ? b : detail::next_record(b - 1, end,
+                                                          delimiter));
+  }
+  bounds.push_back(end);
+
+  std::vector<std::vector<parser<T>>> chunk_results(n_chunks);
+  std::atomic<size_t> next_chunk{0};
+
+  const auto work{[&] {
+    for (size_t c; (c = next_chunk.fetch_add(1)) < n_chunks;) {
+      auto &out{chunk_results[c]};
+      for (const char *it{bounds[c]}; it != bounds[c + 1];) {
+        const char *next{detail::next_record(it, bounds[c + 1], delimiter)};
+        const bool delimited{next[-1] == delimiter};
+        str_pos pos{it, delimited ? next - 1 : next};
+        auto ret{p(pos)};
+        if (ret && !pos.at_end()) {
+          ret.reset();
+        }
+        out.push_back(std::move(ret));
+        it = next;
+      }
+    }
+  }};
+
+  std::vector<std::thread> threads;
+  threads.reserve(n_threads - 1);
+  for (size_t i{1}; i < n_threads && i < n_chunks; ++i) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  parallel_records<T> ret;
+  size_t n_records{0};
+  for (const auto &r : chunk_results) {
+    n_records += r.size();
+  }
+  ret.results.reserve(n_records);
+  for (auto &r : chunk_results) {
+    for (auto &record : r) {
+      if (!record) {
+        ret.failures.push_back(ret.results.size());
+      }
+      ret.results.push_back(std::move(record));
+    }
+  }
+  return ret;
+}
+
+} // namespace apl
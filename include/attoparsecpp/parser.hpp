@@ -1,56 +1,121 @@
 #pragma once
 
+#include <array>
+#include <cassert>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iterator>
+#include <memory>
 #include <optional>
+#if __has_include(<span>)
+#include <span>
+#endif
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 namespace apl {
 
+// Defining __USE_OWN_STRPOS_IMPL__ replaces str_pos with an own type. Besides
+// the constructors from a begin/end pointer pair and from std::string_view,
+// it has to provide the members below. Scanning loops work on the raw span
+// that data() and remaining() describe and move on with advance().
 #ifndef __USE_OWN_STRPOS_IMPL__
 
 struct str_pos {
-  using str_it = std::string::const_iterator;
+  using str_it = const char *;
 
   str_it it;
   str_it end_it;
 
-  str_pos(const std::string &s) : it{s.cbegin()}, end_it{s.cend()} {}
+  constexpr str_pos(const char *begin, const char *end)
+      : it{begin}, end_it{end} {}
+  constexpr str_pos(const char *data, size_t size)
+      : str_pos{data, data + size} {}
+  constexpr str_pos(std::string_view s) : str_pos{s.data(), s.size()} {}
+  constexpr str_pos(const char *s) : str_pos{std::string_view{s}} {}
+  str_pos(const std::string &s) : str_pos{s.data(), s.size()} {}
+#ifdef __cpp_lib_span
+  constexpr str_pos(std::span<const char> s) : str_pos{s.data(), s.size()} {}
+#endif
 
-  std::optional<char> peek() const {
+  constexpr std::optional<char> peek() const {
     if (!at_end()) {
       return {*it};
     }
     return {};
   }
 
-  char operator*() const { return *it; }
+  constexpr char operator*() const { return *it; }
 
-  str_pos &next() {
+  constexpr str_pos &next() {
     ++it;
     return *this;
   }
 
-  char consume() { return *(it++); }
+  constexpr char consume() { return *(it++); }
+
+  constexpr size_t size() const { return end_it - it; }
+
+  constexpr bool at_end() const { return size() == 0; }
+
+  // Characters between this position and the later position `other`.
+  constexpr std::string_view view_to(const str_pos &other) const {
+    return {it, size() - other.size()};
+  }
 
-  size_t size() const { return end_it - it; }
+  // The current character in memory, and the input from there on.
+  constexpr const char *data() const { return it; }
+  constexpr std::string_view remaining() const { return {it, size()}; }
 
-  bool at_end() const { return size() == 0; }
+  // Skips n characters, which must not be more than size().
+  constexpr str_pos &advance(size_t n) {
+    it += n;
+    return *this;
+  }
 };
 
 #endif
 
 template <typename T> using parser = std::optional<T>;
 
+// Payload of parsers that only advance the position and produce no value.
+struct unit {
+  constexpr bool operator==(unit) const { return true; }
+  constexpr bool operator!=(unit) const { return false; }
+};
+
 template <typename Parser>
 using parser_ret = std::invoke_result_t<Parser, str_pos &>;
 
 template <typename Parser>
 using parser_payload_type = typename parser_ret<Parser>::value_type;
 
-template <typename F> static auto not_at_end(F f) {
+namespace detail {
+
+// True during constant evaluation, where the SIMD and memcpy fast paths
+// cannot run.
+constexpr bool is_constant_evaluated() {
+#ifdef __cpp_lib_is_constant_evaluated
+  return std::is_constant_evaluated();
+#else
+  return __builtin_is_constant_evaluated();
+#endif
+}
+
+} // namespace detail
+
+template <typename F> static constexpr auto not_at_end(F f) {
   return [f](str_pos &p) -> parser<parser_payload_type<F>> {
     if (p.at_end()) {
       return {};
@@ -59,14 +124,12 @@ template <typename F> static auto not_at_end(F f) {
   };
 }
 
-static parser<char> anyChar(str_pos &pos) __attribute__((unused));
-
-static parser<char> anyChar(str_pos &pos) {
+static constexpr parser<char> anyChar(str_pos &pos) {
   return not_at_end([](str_pos &p) -> parser<char> { return {p.consume()}; })(
       pos);
 }
 
-template <typename F> static auto sat(F predicate) {
+template <typename F> static constexpr auto sat(F predicate) {
   return not_at_end([predicate](str_pos &p) -> parser<char> {
     if (predicate(*p)) {
       return {p.consume()};
@@ -75,96 +138,491 @@ template <typename F> static auto sat(F predicate) {
   });
 }
 
-static parser<char> number(str_pos &pos) __attribute__((unused));
+// Set of characters stored as a 256 bit table, so testing membership is a
+// single load and bit test no matter how many characters the class contains.
+// Classes are built at compile time from character lists (chars<...>) and
+// ranges (range<...>) and combined with |, & and ~.
+class char_class {
+  std::array<uint64_t, 4> bits{};
 
-static parser<char> number(str_pos &pos) {
-  return sat([](char c) { return '0' <= c && c <= '9'; })(pos);
-}
+  static constexpr uint64_t bit(uint8_t u) { return uint64_t{1} << (u & 63); }
 
-static parser<char> hexnumber(str_pos &pos) __attribute__((unused));
+public:
+  constexpr char_class() = default;
 
-static parser<char> hexnumber(str_pos &pos) {
-  return sat([](char c) {
-    return ('0' <= c && c <= '9') || ('a' <= c && c <= 'f');
-  })(pos);
-}
+  constexpr explicit char_class(std::string_view cs) {
+    for (const char c : cs) {
+      add(c);
+    }
+  }
+
+  constexpr char_class &add(char c) {
+    const auto u{static_cast<uint8_t>(c)};
+    bits[u >> 6] |= bit(u);
+    return *this;
+  }
+
+  constexpr char_class &add_range(char from, char to) {
+    for (size_t u{static_cast<uint8_t>(from)}; u <= static_cast<uint8_t>(to);
+         ++u) {
+      add(static_cast<char>(u));
+    }
+    return *this;
+  }
+
+  constexpr bool contains(char c) const {
+    const auto u{static_cast<uint8_t>(c)};
+    return (bits[u >> 6] >> (u & 63)) & 1;
+  }
+
+  constexpr bool operator()(char c) const { return contains(c); }
+
+  constexpr char_class operator|(const char_class &o) const {
+    char_class r;
+    for (size_t i{0}; i < bits.size(); ++i) {
+      r.bits[i] = bits[i] | o.bits[i];
+    }
+    return r;
+  }
+
+  constexpr char_class operator&(const char_class &o) const {
+    char_class r;
+    for (size_t i{0}; i < bits.size(); ++i) {
+      r.bits[i] = bits[i] & o.bits[i];
+    }
+    return r;
+  }
+
+  constexpr char_class operator~() const {
+    char_class r;
+    for (size_t i{0}; i < bits.size(); ++i) {
+      r.bits[i] = ~bits[i];
+    }
+    return r;
+  }
+};
+
+template <char From, char To>
+inline constexpr char_class range{char_class{}.add_range(From, To)};
+
+template <char... Cs>
+inline constexpr char_class chars{std::string_view{
+    std::array<char, sizeof...(Cs)>{Cs...}.data(), sizeof...(Cs)}};
+
+inline constexpr char_class digit_class{range<'0', '9'>};
+inline constexpr char_class hex_digit_class{digit_class | range<'a', 'f'> |
+                                            range<'A', 'F'>};
+inline constexpr char_class lower_class{range<'a', 'z'>};
+inline constexpr char_class upper_class{range<'A', 'Z'>};
+inline constexpr char_class alpha_class{lower_class | upper_class};
+inline constexpr char_class alnum_class{alpha_class | digit_class};
+inline constexpr char_class blank_class{chars<' ', '\t'>};
+inline constexpr char_class space_class{blank_class |
+                                        chars<'\n', '\r', '\v', '\f'>};
+
+namespace detail {
+
+// Single character parser returned by sat() for a char_class.
+struct class_parser {
+  char_class cls;
+
+  constexpr parser<char> operator()(str_pos &p) const {
+    if (!p.at_end() && cls.contains(*p)) {
+      return {p.consume()};
+    }
+    return {};
+  }
+
+  constexpr const char *scan(const char *b, const char *e) const {
+    // Four bit tests per step do not wait for each other.
+    while (e - b >= 4 && (cls.contains(b[0]) & cls.contains(b[1]) &
+                          cls.contains(b[2]) & cls.contains(b[3]))) {
+      b += 4;
+    }
+    while (b != e && cls.contains(*b)) {
+      ++b;
+    }
+    return b;
+  }
+
+  constexpr char_class first_set() const { return cls; }
+};
+
+} // namespace detail
+
+static constexpr auto sat(char_class cls) { return detail::class_parser{cls}; }
+
+inline constexpr detail::class_parser number{digit_class};
+
+inline constexpr detail::class_parser hexnumber{hex_digit_class};
 
 namespace detail {
 
 template <typename L, typename T>
-static bool equalTo(const L &lhs, const T &rhs) {
+static constexpr bool equalTo(const L &lhs, const T &rhs) {
   return lhs == rhs;
 }
 
 template <typename L, typename T, typename... Ts>
-static bool equalTo(const L &lhs, const T &rhs, const Ts &...ts) {
+static constexpr bool equalTo(const L &lhs, const T &rhs, const Ts &...ts) {
   return lhs == rhs || equalTo(lhs, ts...);
 }
 
 template <typename L, typename T>
-static bool unequalTo(const L &lhs, const T &rhs) {
+static constexpr bool unequalTo(const L &lhs, const T &rhs) {
   return lhs != rhs;
 }
 template <typename L, typename T, typename... Ts>
-static bool unequalTo(const L &lhs, const T &rhs, const Ts &...ts) {
+static constexpr bool unequalTo(const L &lhs, const T &rhs, const Ts &...ts) {
   return lhs != rhs && unequalTo(lhs, ts...);
 }
 
+// True if c is (Accept) or is not (!Accept) contained in cs.
+template <bool Accept, size_t N>
+static constexpr bool set_matches(char c, const std::array<char, N> &cs) {
+  return std::apply(
+      [c](auto... xs) {
+        if constexpr (Accept) {
+          return equalTo(c, xs...);
+        } else {
+          return unequalTo(c, xs...);
+        }
+      },
+      cs);
+}
+
+// Returns the first position in [b, e) that breaks the run of characters
+// matching set_matches<Accept>.
+template <bool Accept, size_t N>
+static constexpr const char *scan_set_scalar(const std::array<char, N> &cs,
+                                             const char *b, const char *e) {
+  while (b != e && set_matches<Accept>(*b, cs)) {
+    ++b;
+  }
+  return b;
+}
+
+// Vectorized version of scan_set_scalar: compares 32 (AVX2) or 16 (SSE2)
+// characters per step against every character in cs and only falls back to
+// the scalar loop for the tail that does not fill a whole register.
+template <bool Accept, size_t N>
+static const char *scan_set_simd(const std::array<char, N> &cs, const char *b,
+                                 const char *e) {
+#ifdef __AVX2__
+  if (e - b >= 32) {
+    __m256i needles[N];
+    for (size_t i{0}; i < N; ++i) {
+      needles[i] = _mm256_set1_epi8(cs[i]);
+    }
+    for (; e - b >= 32; b += 32) {
+      const __m256i block{
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b))};
+      __m256i hits{_mm256_setzero_si256()};
+      for (const auto &needle : needles) {
+        hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(block, needle));
+      }
+      auto stop{static_cast<uint32_t>(_mm256_movemask_epi8(hits))};
+      if constexpr (Accept) {
+        stop = ~stop;
+      }
+      if (stop) {
+        return b + __builtin_ctz(stop);
+      }
+    }
+  }
+#endif
+#ifdef __SSE2__
+  if (e - b >= 16) {
+    __m128i needles[N];
+    for (size_t i{0}; i < N; ++i) {
+      needles[i] = _mm_set1_epi8(cs[i]);
+    }
+    for (; e - b >= 16; b += 16) {
+      const __m128i block{
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(b))};
+      __m128i hits{_mm_setzero_si128()};
+      for (const auto &needle : needles) {
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, needle));
+      }
+      auto stop{static_cast<uint32_t>(_mm_movemask_epi8(hits))};
+      if constexpr (Accept) {
+        stop = ~stop & 0xffffu;
+      }
+      if (stop) {
+        return b + __builtin_ctz(stop);
+      }
+    }
+  }
+#endif
+  return scan_set_scalar<Accept>(cs, b, e);
+}
+
+template <bool Accept, size_t N>
+static constexpr const char *scan_set(const std::array<char, N> &cs,
+                                      const char *b, const char *e) {
+  if (is_constant_evaluated()) {
+    return scan_set_scalar<Accept>(cs, b, e);
+  }
+  return scan_set_simd<Accept>(cs, b, e);
+}
+
+// Single character parser returned by oneOf (Accept) and noneOf (!Accept).
+// Its scan() member lets many() and friends consume whole runs at once.
+template <bool Accept, size_t N> struct char_set_parser {
+  std::array<char, N> cs;
+
+  constexpr parser<char> operator()(str_pos &p) const {
+    if (!p.at_end() && set_matches<Accept>(*p, cs)) {
+      return {p.consume()};
+    }
+    return {};
+  }
+
+  constexpr const char *scan(const char *b, const char *e) const {
+    return scan_set<Accept>(cs, b, e);
+  }
+
+  constexpr char_class first_set() const {
+    char_class cls{std::string_view{cs.data(), N}};
+    if constexpr (Accept) {
+      return cls;
+    } else {
+      return ~cls;
+    }
+  }
+};
+
+template <typename Parser, typename = void>
+struct is_run_scanner : std::false_type {};
+
+template <typename Parser>
+struct is_run_scanner<
+    Parser, std::void_t<decltype(std::declval<const Parser &>().scan(
+                std::declval<const char *>(), std::declval<const char *>()))>>
+    : std::true_type {};
+
+// Advances pos past every character that repeated application of p accepts.
+template <typename Parser>
+static constexpr void skip_run(const Parser &p, str_pos &pos) {
+  if constexpr (is_run_scanner<Parser>::value) {
+    const std::string_view r{pos.remaining()};
+    pos.advance(
+        static_cast<size_t>(p.scan(r.data(), r.data() + r.size()) - r.data()));
+  } else {
+    while (p(pos)) {
+    }
+  }
+}
+
 } // namespace detail
 
-template <typename... Cs> static auto noneOf(Cs... cs) {
-  return sat([cs...](char c) { return detail::unequalTo(c, cs...); });
+template <typename... Cs> static constexpr auto noneOf(Cs... cs) {
+  return detail::char_set_parser<false, sizeof...(Cs)>{
+      {static_cast<char>(cs)...}};
 }
 
-template <typename... Cs> static auto oneOf(Cs... cs) {
-  return sat([cs...](char c) { return detail::equalTo(c, cs...); });
+template <typename... Cs> static constexpr auto oneOf(Cs... cs) {
+  return detail::char_set_parser<true, sizeof...(Cs)>{
+      {static_cast<char>(cs)...}};
+}
+
+namespace detail {
+
+// Consumes s if the input continues with it. The comparison is a single
+// length check plus char_traits::compare, which compiles to memcmp.
+static constexpr bool match_string(str_pos &pos, std::string_view s) {
+  if (pos.remaining().substr(0, s.size()) != s) {
+    return false;
+  }
+  pos.advance(s.size());
+  return true;
 }
 
+// Parser behind const_string and its non-allocating variants.
+// Payload is std::string (a copy of s), std::string_view (the matched input)
+// or unit.
+template <typename Payload, typename String> struct string_parser {
+  String s;
+
+  constexpr parser<Payload> operator()(str_pos &pos) const {
+    const str_pos start{pos};
+    if (!match_string(pos, s)) {
+      return {};
+    }
+    if constexpr (std::is_same_v<Payload, unit>) {
+      return {unit{}};
+    } else if constexpr (std::is_same_v<Payload, std::string_view>) {
+      return {start.view_to(pos)};
+    } else {
+      return {s};
+    }
+  }
+
+  constexpr char_class first_set() const {
+    if (s.empty()) {
+      return ~char_class{};
+    }
+    return char_class{}.add(s.front());
+  }
+};
+
+} // namespace detail
+
 static auto const_string(std::string s) __attribute__((unused));
 
 static auto const_string(std::string s) {
-  return [s](str_pos &pos) -> parser<std::string> {
-    for (const char c : s) {
-      if (auto ret{oneOf(c)(pos)}) {
-      } else {
-        return {};
+  return detail::string_parser<std::string, std::string>{std::move(s)};
+}
+
+// Variants of const_string that never allocate: const_string_view returns
+// the matched part of the input, skip_string returns nothing.
+// They keep a view of s, which therefore has to outlive the parser.
+static constexpr auto const_string_view(std::string_view s) {
+  return detail::string_parser<std::string_view, std::string_view>{s};
+}
+
+static constexpr auto skip_string(std::string_view s) {
+  return detail::string_parser<unit, std::string_view>{s};
+}
+
+namespace detail {
+
+template <typename Allocator, typename T>
+using rebind_alloc =
+    typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+} // namespace detail
+
+// The *_alloc variants of many, manyV and sep_by allocate their results
+// with the given allocator (rebound to the element type), e.g. a
+// std::pmr::polymorphic_allocator on top of a monotonic arena.
+template <typename Parser, typename Allocator>
+static auto many_alloc(Parser p, Allocator alloc, bool minimum_one = false) {
+  using string_type = std::basic_string<char, std::char_traits<char>,
+                                        detail::rebind_alloc<Allocator, char>>;
+  return [p, alloc, minimum_one](str_pos &pos) -> parser<string_type> {
+    string_type s(alloc);
+    if constexpr (detail::is_run_scanner<Parser>::value) {
+      const str_pos start{pos};
+      detail::skip_run(p, pos);
+      s = start.view_to(pos);
+    } else {
+      while (auto ret{p(pos)}) {
+        s.push_back(*ret);
       }
     }
-    return {s};
+    if (minimum_one && s.empty()) {
+      return {};
+    }
+    return {std::move(s)};
   };
 }
 
 template <typename Parser>
 static auto many(Parser p, bool minimum_one = false) {
-  return [p, minimum_one](str_pos &pos) -> parser<std::string> {
-    std::string s;
-    while (auto ret{p(pos)}) {
-      s.push_back(*ret);
+  return many_alloc(p, std::allocator<char>{}, minimum_one);
+}
+
+template <typename Parser> static auto many1(Parser p) { return many(p, true); }
+
+// Like many(), but returns a view into the input instead of copying the
+// matched characters into a new string.
+template <typename Parser>
+static constexpr auto many_view(Parser p, bool minimum_one = false) {
+  return [p, minimum_one](str_pos &pos) -> parser<std::string_view> {
+    const str_pos start{pos};
+    detail::skip_run(p, pos);
+    const auto v{start.view_to(pos)};
+    if (minimum_one && v.empty()) {
+      return {};
     }
-    if (minimum_one && s.empty()) {
+    return {v};
+  };
+}
+
+template <typename Parser> static constexpr auto many1_view(Parser p) {
+  return many_view(p, true);
+}
+
+template <typename F>
+static constexpr auto take_while(F predicate, bool minimum_one = false) {
+  return [predicate, minimum_one](str_pos &pos) -> parser<std::string_view> {
+    const str_pos start{pos};
+    while (!pos.at_end() && predicate(*pos)) {
+      pos.next();
+    }
+    const auto v{start.view_to(pos)};
+    if (minimum_one && v.empty()) {
       return {};
     }
-    return {std::move(s)};
+    return {v};
   };
 }
 
-template <typename Parser> static auto many1(Parser p) { return many(p, true); }
+template <typename F> static constexpr auto take_while1(F predicate) {
+  return take_while(predicate, true);
+}
+
+// The skip_* family consumes the same input as its many/take_while
+// counterpart but does not build a payload, so it never allocates.
+template <typename Parser>
+static constexpr auto skip_many(Parser p, bool minimum_one = false) {
+  return [p, minimum_one](str_pos &pos) -> parser<unit> {
+    const size_t before{pos.size()};
+    detail::skip_run(p, pos);
+    if (minimum_one && pos.size() == before) {
+      return {};
+    }
+    return {unit{}};
+  };
+}
+
+template <typename Parser> static constexpr auto skip_many1(Parser p) {
+  return skip_many(p, true);
+}
+
+template <typename F>
+static constexpr auto skip_while(F predicate, bool minimum_one = false) {
+  return [predicate, minimum_one](str_pos &pos) -> parser<unit> {
+    const size_t before{pos.size()};
+    while (!pos.at_end() && predicate(*pos)) {
+      pos.next();
+    }
+    if (minimum_one && pos.size() == before) {
+      return {};
+    }
+    return {unit{}};
+  };
+}
+
+template <typename F> static constexpr auto skip_while1(F predicate) {
+  return skip_while(predicate, true);
+}
+
+template <typename Parser, typename Allocator,
+          typename T = parser_payload_type<Parser>>
+static auto manyV_alloc(Parser p, Allocator alloc, bool minimum_one = false,
+                        size_t reserve_items = 0) {
+  using vector_type = std::vector<T, detail::rebind_alloc<Allocator, T>>;
+  return [p, alloc, minimum_one,
+          reserve_items](str_pos &pos) -> parser<vector_type> {
+    vector_type v(alloc);
+    v.reserve(reserve_items);
+    while (auto ret{p(pos)}) {
+      v.emplace_back(std::move(*ret));
+    }
+    if (minimum_one && v.empty()) {
+      return {};
+    }
+    return {std::move(v)};
+  };
+}
 
 template <typename Parser, typename T = parser_payload_type<Parser>>
 static auto manyV(Parser p, bool minimum_one = false,
                   size_t reserve_items = 0) {
-  return
-      [p, minimum_one, reserve_items](str_pos &pos) -> parser<std::vector<T>> {
-        std::vector<T> v;
-        v.reserve(reserve_items);
-        while (auto ret{p(pos)}) {
-          v.push_back(*ret);
-        }
-        if (minimum_one && v.empty()) {
-          return {};
-        }
-        return {std::move(v)};
-      };
+  return manyV_alloc<Parser, std::allocator<T>, T>(p, {}, minimum_one,
+                                                   reserve_items);
 }
 
 template <typename Parser>
@@ -172,23 +630,142 @@ static auto manyV1(Parser p, size_t reserve_items = 0) {
   return manyV(p, true, reserve_items);
 }
 
+// The *_into variants of manyV and sep_by return filling parsers, which are
+// called as f(pos, out) and return the number of items. They clear the
+// caller's container out and append the items to it, so a container that is
+// reused for similar inputs keeps its capacity and stops allocating.
+// parse_into() runs them on an input.
+template <typename Parser>
+static auto manyV_into(Parser p, bool minimum_one = false) {
+  return [p, minimum_one](str_pos &pos, auto &out) -> parser<size_t> {
+    out.clear();
+    while (auto ret{p(pos)}) {
+      out.emplace_back(std::move(*ret));
+    }
+    if (minimum_one && out.empty()) {
+      return {};
+    }
+    return {out.size()};
+  };
+}
+
+// Reduces the payloads of repeated applications of p with f, starting with
+// init, without collecting them in a container first.
+template <typename Parser, typename Acc, typename F>
+static constexpr auto many_fold(Parser p, Acc init, F f,
+                                bool minimum_one = false) {
+  return [p, init, f, minimum_one](str_pos &pos) -> parser<Acc> {
+    Acc accum{init};
+    bool any{false};
+    while (auto ret{p(pos)}) {
+      accum = f(std::move(accum), std::move(*ret));
+      any = true;
+    }
+    if (minimum_one && !any) {
+      return {};
+    }
+    return {std::move(accum)};
+  };
+}
+
+// Counts how often p can be applied in a row.
+template <typename Parser> static constexpr auto many_count(Parser p) {
+  return [p](str_pos &pos) -> parser<size_t> {
+    if constexpr (detail::is_run_scanner<Parser>::value) {
+      const size_t before{pos.size()};
+      detail::skip_run(p, pos);
+      return {before - pos.size()};
+    } else {
+      size_t n{0};
+      while (p(pos)) {
+        ++n;
+      }
+      return {n};
+    }
+  };
+}
+
+namespace detail {
+
+// Value of every character as a digit in bases up to 36, 0xff for
+// characters that are no digit at all.
+inline constexpr auto digit_values{[] {
+  std::array<uint8_t, 256> t{};
+  for (auto &v : t) {
+    v = 0xff;
+  }
+  for (uint8_t i{0}; i < 10; ++i) {
+    t['0' + i] = i;
+  }
+  for (uint8_t i{0}; i < 26; ++i) {
+    t['a' + i] = 10 + i;
+    t['A' + i] = 10 + i;
+  }
+  return t;
+}()};
+
+// Converts 8 decimal digits at once using SIMD within a register.
+// Returns false if any of the 8 characters is no decimal digit.
+static constexpr bool parse_8_digits(const char *s, uint32_t &out) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  if (is_constant_evaluated()) {
+    return false;
+  }
+  uint64_t v{0};
+  std::memcpy(&v, s, sizeof(v));
+  if (((v & 0xf0f0f0f0f0f0f0f0ull) |
+       (((v + 0x0606060606060606ull) & 0xf0f0f0f0f0f0f0f0ull) >> 4)) !=
+      0x3333333333333333ull) {
+    return false;
+  }
+  v -= 0x3030303030303030ull;
+  v = (v * 10) + (v >> 8);
+  v = (((v & 0x000000ff000000ffull) * (100 + (1000000ull << 32))) +
+       (((v >> 16) & 0x000000ff000000ffull) * (1 + (10000ull << 32)))) >>
+      32;
+  out = static_cast<uint32_t>(v);
+  return true;
+#else
+  (void)s;
+  (void)out;
+  return false;
+#endif
+}
+
+} // namespace detail
+
+// Parses an unsigned number of at most max_digits digits in the given base
+// (2 to 36, letters in either case). Fails if the value does not fit into
+// IntType.
 template <typename IntType = int>
-static auto base_integer(size_t base, size_t max_digits = ~0ull) {
+static constexpr auto base_integer(size_t base, size_t max_digits = ~0ull) {
   return [base, max_digits](str_pos &p) -> parser<IntType> {
     IntType accum{0};
     size_t digits{0};
-    const auto num_f = base == 16 ? hexnumber : number;
-    parser_ret<decltype(num_f)> ret;
-    while (digits < max_digits && (ret = num_f(p))) {
-      ++digits;
-      const char c{*ret};
-      accum = base * accum + c;
-      if (base == 16 && ('a' <= c && c <= 'z')) {
-        accum = accum + 10 - 'a';
-      } else {
-        accum -= '0';
+    if (base == 10) {
+      uint32_t chunk{0};
+      while (max_digits - digits >= 8 && p.size() >= 8 &&
+             detail::parse_8_digits(p.data(), chunk)) {
+        if (__builtin_mul_overflow(accum, 100000000, &accum) ||
+            __builtin_add_overflow(accum, chunk, &accum)) {
+          return {};
+        }
+        p.advance(8);
+        digits += 8;
       }
     }
+    while (digits < max_digits && !p.at_end()) {
+      const uint8_t d{detail::digit_values[static_cast<uint8_t>(*p)]};
+      if (d >= base) {
+        break;
+      }
+      if (__builtin_mul_overflow(accum, base, &accum) ||
+          __builtin_add_overflow(accum, d, &accum)) {
+        return {};
+      }
+      p.next();
+      ++digits;
+    }
     if (!digits) {
       return {};
     }
@@ -196,9 +773,7 @@ static auto base_integer(size_t base, size_t max_digits = ~0ull) {
   };
 }
 
-static parser<int> integer(str_pos &p) __attribute__((unused));
-
-static parser<int> integer(str_pos &p) {
+static constexpr parser<int> integer(str_pos &p) {
   return not_at_end([](str_pos &pos) -> parser<int> {
     size_t base{10};
     if (*pos == '0') {
@@ -206,10 +781,11 @@ static parser<int> integer(str_pos &p) {
       pos = pos.next();
       if (pos.at_end()) {
         return {0};
-      } else if (*pos == 'x') {
+      } else if (*pos == 'x' || *pos == 'X') {
         base = 16;
         pos = pos.next();
-      } else if (*pos < '0' || '9' < *pos) {
+      } else if (*pos < '0' || '7' < *pos) {
+        // Like "08": the number is the leading zero.
         return {0};
       }
     }
@@ -217,24 +793,148 @@ static parser<int> integer(str_pos &p) {
   })(p);
 }
 
-template <typename Parser> static auto token(Parser parser) {
+namespace detail {
+
+static const char *skip_digits(const char *b, const char *e)
+    __attribute__((unused));
+
+static const char *skip_digits(const char *b, const char *e) {
+  while (b != e && static_cast<uint8_t>(*b - '0') < 10) {
+    ++b;
+  }
+  return b;
+}
+
+// Returns the end of the longest decimal floating point literal
+// [+-]? digits [. digits] [(e|E) [+-]? digits] at the beginning of [b, e),
+// or b if there is none.
+static const char *scan_float_literal(const char *b, const char *e)
+    __attribute__((unused));
+
+static const char *scan_float_literal(const char *b, const char *e) {
+  const char *it{b};
+  if (it != e && (*it == '-' || *it == '+')) {
+    ++it;
+  }
+  const char *mantissa{it};
+  it = skip_digits(it, e);
+  size_t digits(it - mantissa);
+  if (it != e && *it == '.') {
+    const char *fraction{++it};
+    it = skip_digits(it, e);
+    digits += it - fraction;
+  }
+  if (!digits) {
+    return b;
+  }
+  if (it != e && (*it == 'e' || *it == 'E')) {
+    const char *exponent{it + 1};
+    if (exponent != e && (*exponent == '-' || *exponent == '+')) {
+      ++exponent;
+    }
+    const char *exponent_end{skip_digits(exponent, e)};
+    if (exponent_end != exponent) {
+      it = exponent_end;
+    }
+  }
+  return it;
+}
+
+template <typename FloatType>
+static bool convert_float(const char *b, const char *e, FloatType &out) {
+  if (*b == '+') {
+    ++b;
+  }
+#if defined(__cpp_lib_to_chars)
+  const auto r{std::from_chars(b, e, out)};
+  return r.ec == std::errc{} && r.ptr == e;
+#else
+  // Standard libraries without floating point from_chars: strtod needs
+  // a terminated copy of the literal, which normally fits on the stack.
+  std::array<char, 64> buf;
+  std::string long_buf;
+  char *str{buf.data()};
+  const size_t n(e - b);
+  if (n < buf.size()) {
+    std::memcpy(str, b, n);
+    str[n] = '\0';
+  } else {
+    long_buf.assign(b, e);
+    str = long_buf.data();
+  }
+  char *end;
+  errno = 0;
+  if constexpr (std::is_same_v<FloatType, float>) {
+    out = std::strtof(str, &end);
+  } else if constexpr (std::is_same_v<FloatType, double>) {
+    out = std::strtod(str, &end);
+  } else {
+    out = std::strtold(str, &end);
+  }
+  return errno != ERANGE && end == str + n;
+#endif
+}
+
+} // namespace detail
+
+// Parses a decimal or scientific floating point literal in place.
+// Conversion is correctly rounded and independent of the C locale when the
+// standard library implements std::from_chars for floating point types.
+// Fails if the value is out of the range of FloatType.
+template <typename FloatType> static parser<FloatType> floating(str_pos &p) {
+  const std::string_view r{p.remaining()};
+  const char *end{detail::scan_float_literal(r.data(), r.data() + r.size())};
+  if (end == r.data()) {
+    return {};
+  }
+  FloatType value;
+  if (!detail::convert_float(r.data(), end, value)) {
+    return {};
+  }
+  p.advance(static_cast<size_t>(end - r.data()));
+  return {value};
+}
+
+static parser<double> double_(str_pos &p) __attribute__((unused));
+
+static parser<double> double_(str_pos &p) { return floating<double>(p); }
+
+static parser<float> float_(str_pos &p) __attribute__((unused));
+
+static parser<float> float_(str_pos &p) { return floating<float>(p); }
+
+// Runs parser and skips the blanks after it. The overload with a whitespace
+// class skips that class instead.
+template <typename Parser> static constexpr auto token(Parser parser) {
   return not_at_end([parser](str_pos &p) -> parser_ret<Parser> {
     if (auto ret{parser(p)}) {
-      if (auto ret2{many(oneOf(' ', '\t'))(p)}) {
-        return ret;
-      }
+      skip_while(blank_class)(p);
+      return ret;
     }
     return {};
   });
 }
 
-template <typename TParser, typename SepParser,
+template <typename Parser>
+static constexpr auto token(Parser parser, char_class whitespace) {
+  return not_at_end([parser, whitespace](str_pos &p) -> parser_ret<Parser> {
+    if (auto ret{parser(p)}) {
+      skip_while(whitespace)(p);
+      return ret;
+    }
+    return {};
+  });
+}
+
+template <typename TParser, typename SepParser, typename Allocator,
           typename T = parser_payload_type<TParser>>
-static auto sep_by(TParser item_parser, SepParser sep_parser,
-                   bool minimum_one = false, size_t reserve_items = 0) {
-  return [item_parser, sep_parser, minimum_one,
-          reserve_items](str_pos &pos) -> parser<std::vector<T>> {
-    std::vector<T> v;
+static auto sep_by_alloc(TParser item_parser, SepParser sep_parser,
+                         Allocator alloc, bool minimum_one = false,
+                         size_t reserve_items = 0) {
+  using vector_type = std::vector<T, detail::rebind_alloc<Allocator, T>>;
+  return [item_parser, sep_parser, alloc, minimum_one,
+          reserve_items](str_pos &pos) -> parser<vector_type> {
+    vector_type v(alloc);
     v.reserve(reserve_items);
     while (auto ret{item_parser(pos)}) {
       v.emplace_back(std::move(*ret));
@@ -250,6 +950,14 @@ static auto sep_by(TParser item_parser, SepParser sep_parser,
   };
 }
 
+template <typename TParser, typename SepParser,
+          typename T = parser_payload_type<TParser>>
+static auto sep_by(TParser item_parser, SepParser sep_parser,
+                   bool minimum_one = false, size_t reserve_items = 0) {
+  return sep_by_alloc<TParser, SepParser, std::allocator<T>, T>(
+      item_parser, sep_parser, {}, minimum_one, reserve_items);
+}
+
 template <typename TParser, typename SepParser,
           typename T = parser_payload_type<TParser>>
 static auto sep_by1(TParser item_parser, SepParser sep_parser,
@@ -257,10 +965,53 @@ static auto sep_by1(TParser item_parser, SepParser sep_parser,
   return sep_by(item_parser, sep_parser, true, reserve_items);
 }
 
+template <typename TParser, typename SepParser>
+static auto sep_by_into(TParser item_parser, SepParser sep_parser,
+                        bool minimum_one = false) {
+  return [item_parser, sep_parser, minimum_one](str_pos &pos,
+                                                auto &out) -> parser<size_t> {
+    out.clear();
+    while (auto ret{item_parser(pos)}) {
+      out.emplace_back(std::move(*ret));
+      auto sep_ret{sep_parser(pos)};
+      if (!sep_ret) {
+        break;
+      }
+    }
+    if (minimum_one && out.empty()) {
+      return {};
+    }
+    return {out.size()};
+  };
+}
+
+// sep_by counterpart of many_fold.
+template <typename TParser, typename SepParser, typename Acc, typename F>
+static constexpr auto sep_by_fold(TParser item_parser, SepParser sep_parser,
+                                  Acc init, F f, bool minimum_one = false) {
+  return [item_parser, sep_parser, init, f,
+          minimum_one](str_pos &pos) -> parser<Acc> {
+    Acc accum{init};
+    bool any{false};
+    while (auto ret{item_parser(pos)}) {
+      accum = f(std::move(accum), std::move(*ret));
+      any = true;
+      auto sep_ret{sep_parser(pos)};
+      if (!sep_ret) {
+        break;
+      }
+    }
+    if (minimum_one && !any) {
+      return {};
+    }
+    return {std::move(accum)};
+  };
+}
+
 namespace detail {
 
 template <typename Parser>
-static parser<std::tuple<parser_payload_type<Parser>>>
+static constexpr parser<std::tuple<parser_payload_type<Parser>>>
 apply_parsers(str_pos &pos, const Parser &parser) {
   if (auto ret{parser(pos)}) {
     return {std::make_tuple(std::move(*ret))};
@@ -269,7 +1020,7 @@ apply_parsers(str_pos &pos, const Parser &parser) {
 }
 
 template <typename Parser, typename... Parsers>
-static parser<
+static constexpr parser<
     std::tuple<parser_payload_type<Parser>, parser_payload_type<Parsers>...>>
 apply_parsers(str_pos &pos, const Parser &parser,
               const Parsers &...rest_parsers) {
@@ -284,14 +1035,15 @@ apply_parsers(str_pos &pos, const Parser &parser,
 
 } // namespace detail
 
-template <typename... Parsers> static auto tuple_of(Parsers... parsers) {
+template <typename... Parsers>
+static constexpr auto tuple_of(Parsers... parsers) {
   return [parsers...](str_pos &pos) {
     return detail::apply_parsers(pos, parsers...);
   };
 }
 
 template <typename Parser1, typename Parser2>
-static auto chainl1(Parser1 item_parser, Parser2 op_parser) {
+static constexpr auto chainl1(Parser1 item_parser, Parser2 op_parser) {
   using T = parser_payload_type<Parser1>;
   return [item_parser, op_parser](str_pos &p) -> parser<T> {
     auto i{item_parser(p)};
@@ -315,8 +1067,169 @@ static auto chainl1(Parser1 item_parser, Parser2 op_parser) {
   };
 }
 
+// Operator table entries for expression(). op parses an operator, and
+// apply(operator, operands...) computes the result. By default the payload of
+// op is called with the operands, like the op_parser of chainl1.
+namespace detail {
+
+enum class op_kind { prefix, postfix, infix_left, infix_right };
+
+struct apply_operator {
+  template <typename Op, typename... Ts>
+  constexpr auto operator()(const Op &op, Ts &&...operands) const {
+    return op(std::forward<Ts>(operands)...);
+  }
+};
+
+template <op_kind Kind, typename OpParser, typename Apply>
+struct operator_level {
+  static constexpr op_kind kind{Kind};
+  OpParser op;
+  Apply apply;
+};
+
+} // namespace detail
+
+template <typename OpParser, typename Apply = detail::apply_operator>
+static constexpr auto prefix(OpParser op, Apply apply = {}) {
+  return detail::operator_level<detail::op_kind::prefix, OpParser, Apply>{
+      op, apply};
+}
+
+template <typename OpParser, typename Apply = detail::apply_operator>
+static constexpr auto postfix(OpParser op, Apply apply = {}) {
+  return detail::operator_level<detail::op_kind::postfix, OpParser, Apply>{
+      op, apply};
+}
+
+template <typename OpParser, typename Apply = detail::apply_operator>
+static constexpr auto infix_left(OpParser op, Apply apply = {}) {
+  return detail::operator_level<detail::op_kind::infix_left, OpParser, Apply>{
+      op, apply};
+}
+
+template <typename OpParser, typename Apply = detail::apply_operator>
+static constexpr auto infix_right(OpParser op, Apply apply = {}) {
+  return detail::operator_level<detail::op_kind::infix_right, OpParser,
+                                Apply>{op, apply};
+}
+
+// Precedence levels of expression(), the loosest binding level first.
+template <typename... Levels>
+static constexpr auto operator_table(Levels... levels) {
+  return std::tuple<Levels...>{levels...};
+}
+
+namespace detail {
+
+// Precedence climbing: operands only recurse for the right hand side of
+// infix and the operand of prefix operators, no matter how many levels the
+// table has.
+template <typename Atom, typename... Levels> class expression_parser {
+  using T = parser_payload_type<Atom>;
+  static constexpr auto indices{std::index_sequence_for<Levels...>{}};
+  template <size_t I>
+  static constexpr op_kind kind{
+      std::tuple_element_t<I, std::tuple<Levels...>>::kind};
+
+  Atom atom;
+  std::tuple<Levels...> levels;
+
+  template <size_t I>
+  constexpr bool apply_prefix(str_pos &pos, parser<T> &ret) const {
+    if constexpr (kind<I> != op_kind::prefix) {
+      return false;
+    } else {
+      const auto &level{std::get<I>(levels)};
+      auto op{level.op(pos)};
+      if (!op) {
+        return false;
+      }
+      if (auto operand{parse(pos, I)}) {
+        ret = level.apply(*op, std::move(*operand));
+      }
+      return true;
+    }
+  }
+
+  // Extends lhs by an operator of level I if that level binds at least as
+  // tightly as min_level. Like chainl1, an infix operator without a right
+  // hand side ends the expression.
+  template <size_t I>
+  constexpr bool apply_suffix(str_pos &pos, size_t min_level, T &lhs,
+                              bool &done) const {
+    if constexpr (kind<I> == op_kind::prefix) {
+      return false;
+    } else {
+      if (I < min_level) {
+        return false;
+      }
+      const auto &level{std::get<I>(levels)};
+      auto op{level.op(pos)};
+      if (!op) {
+        return false;
+      }
+      if constexpr (kind<I> == op_kind::postfix) {
+        lhs = level.apply(*op, std::move(lhs));
+      } else {
+        constexpr bool left{kind<I> == op_kind::infix_left};
+        if (auto rhs{parse(pos, left ? I + 1 : I)}) {
+          lhs = level.apply(*op, std::move(lhs), std::move(*rhs));
+        } else {
+          done = true;
+        }
+      }
+      return true;
+    }
+  }
+
+  template <size_t... Is>
+  constexpr parser<T> parse_operand(str_pos &pos,
+                                    std::index_sequence<Is...>) const {
+    parser<T> ret;
+    if (!(apply_prefix<Is>(pos, ret) || ...)) {
+      ret = atom(pos);
+    }
+    return ret;
+  }
+
+  template <size_t... Is>
+  constexpr parser<T> parse(str_pos &pos, size_t min_level,
+                            std::index_sequence<Is...> is) const {
+    auto lhs{parse_operand(pos, is)};
+    if (!lhs) {
+      return {};
+    }
+    for (bool done{false};
+         !done && (apply_suffix<Is>(pos, min_level, *lhs, done) || ...);) {
+    }
+    return lhs;
+  }
+
+  constexpr parser<T> parse(str_pos &pos, size_t min_level) const {
+    return parse(pos, min_level, indices);
+  }
+
+public:
+  constexpr expression_parser(Atom atom_, std::tuple<Levels...> levels_)
+      : atom{atom_}, levels{levels_} {}
+
+  constexpr parser<T> operator()(str_pos &pos) const {
+    return parse(pos, 0);
+  }
+};
+
+} // namespace detail
+
+// Parses atoms combined with the prefix, postfix and infix operators of an
+// operator_table().
+template <typename Atom, typename... Levels>
+static constexpr auto expression(Atom atom, std::tuple<Levels...> table) {
+  return detail::expression_parser<Atom, Levels...>{atom, table};
+}
+
 template <typename Parser1, typename Parser2>
-static auto prefixed(Parser1 prefix_parser, Parser2 parser) {
+static constexpr auto prefixed(Parser1 prefix_parser, Parser2 parser) {
   return [prefix_parser, parser](str_pos &pos) -> parser_ret<Parser2> {
     if (auto ret1{prefix_parser(pos)}) {
       return parser(pos);
@@ -326,7 +1239,7 @@ static auto prefixed(Parser1 prefix_parser, Parser2 parser) {
 }
 
 template <typename Parser1, typename Parser2>
-static auto postfixed(Parser1 suffix_parser, Parser2 parser) {
+static constexpr auto postfixed(Parser1 suffix_parser, Parser2 parser) {
   return [suffix_parser, parser](str_pos &pos) -> parser_ret<Parser2> {
     if (auto ret1{parser(pos)}) {
       if (auto ret2{suffix_parser(pos)}) {
@@ -338,32 +1251,157 @@ static auto postfixed(Parser1 suffix_parser, Parser2 parser) {
 }
 
 template <typename Parser1, typename Parser2, typename Parser3>
-static auto clasped(Parser1 open_parser, Parser2 close_parser, Parser3 parser) {
+static constexpr auto clasped(Parser1 open_parser, Parser2 close_parser,
+                              Parser3 parser) {
   return postfixed(close_parser, prefixed(open_parser, parser));
 }
 
+// Runs p and rewinds the input to where it started if p fails, so that the
+// next alternative of a choice() sees the same input again.
+template <typename Parser> static constexpr auto attempt(Parser p) {
+  return [p](str_pos &pos) -> parser_ret<Parser> {
+    const str_pos start{pos};
+    auto ret{p(pos)};
+    if (!ret) {
+      pos = start;
+    }
+    return ret;
+  };
+}
+
 namespace detail {
 template <typename Parser>
-static parser_ret<Parser> apply_parser_choice(str_pos &pos, Parser p) {
+static constexpr parser_ret<Parser> apply_parser_choice(str_pos &pos,
+                                                        Parser p) {
   return p(pos);
 }
 
 template <typename Parser, typename... Parsers>
-static parser_ret<Parser> apply_parser_choice(str_pos &pos, Parser p,
-                                              Parsers... ps) {
+static constexpr parser_ret<Parser> apply_parser_choice(str_pos &pos, Parser p,
+                                                        Parsers... ps) {
   if (auto ret{p(pos)}) {
     return ret;
   }
   return apply_parser_choice(pos, ps...);
 }
+
+template <typename Parser, typename = void>
+struct has_first_set : std::false_type {};
+
+template <typename Parser>
+struct has_first_set<
+    Parser, std::void_t<decltype(std::declval<const Parser &>().first_set())>>
+    : std::true_type {};
+
+template <size_t N>
+using choice_mask = std::conditional_t<
+    N <= 8, uint8_t,
+    std::conditional_t<N <= 16, uint16_t,
+                       std::conditional_t<N <= 32, uint32_t, uint64_t>>>;
+
+// Ordered choice that looks up the alternatives which can start with the
+// next input character in a 256 entry table and only tries those.
+// Alternatives without a first_set() are tried for every character.
+// Skipping alternatives does not change the result because a parser with a
+// FIRST set fails on other characters without consuming input.
+template <typename... Parsers> class dispatch_choice {
+  static constexpr size_t N{sizeof...(Parsers)};
+  using mask = choice_mask<N>;
+  using ret_type = parser_ret<std::tuple_element_t<0, std::tuple<Parsers...>>>;
+
+  std::tuple<Parsers...> ps;
+  std::array<mask, 256> table{};
+
+  template <size_t I> constexpr void add_first_set() {
+    using P = std::tuple_element_t<I, std::tuple<Parsers...>>;
+    if constexpr (has_first_set<P>::value) {
+      // Computed once: first_set() may build a whole class, e.g. from a
+      // string of alternatives.
+      const char_class fs{std::get<I>(ps).first_set()};
+      for (size_t c{0}; c < table.size(); ++c) {
+        if (fs.contains(static_cast<char>(c))) {
+          table[c] |= mask{1} << I;
+        }
+      }
+    } else {
+      for (auto &m : table) {
+        m |= mask{1} << I;
+      }
+    }
+  }
+
+  template <size_t I> constexpr ret_type apply(str_pos &pos, mask m) const {
+    if constexpr (I + 1 == N) {
+      if (m & (mask{1} << I)) {
+        return std::get<I>(ps)(pos);
+      }
+      return {};
+    } else {
+      if (m & (mask{1} << I)) {
+        if (auto ret{std::get<I>(ps)(pos)}) {
+          return ret;
+        }
+      }
+      return apply<I + 1>(pos, m);
+    }
+  }
+
+  template <size_t... Is> constexpr void init(std::index_sequence<Is...>) {
+    (add_first_set<Is>(), ...);
+  }
+
+public:
+  constexpr dispatch_choice(Parsers... parsers) : ps{std::move(parsers)...} {
+    init(std::index_sequence_for<Parsers...>{});
+  }
+
+  constexpr ret_type operator()(str_pos &pos) const {
+    const mask m{pos.at_end() ? static_cast<mask>(~mask{0})
+                              : table[static_cast<uint8_t>(*pos)]};
+    return apply<0>(pos, m);
+  }
+};
+
+// Parser returned by with_first_set().
+template <typename Parser> struct first_set_parser {
+  char_class cls;
+  Parser p;
+
+  constexpr parser_ret<Parser> operator()(str_pos &pos) const {
+    return p(pos);
+  }
+
+  constexpr char_class first_set() const { return cls; }
+};
+
 } // namespace detail
 
-template <typename... Parsers> static auto choice(Parsers... ps) {
+// Declares that p fails without consuming input unless the input starts with
+// a character of cls, so choice_first() can dispatch to p by its first
+// character.
+template <typename Parser>
+static constexpr auto with_first_set(char_class cls, Parser p) {
+  return detail::first_set_parser<Parser>{cls, p};
+}
+
+// Tries the parsers in order and returns the first successful result.
+template <typename... Parsers> static constexpr auto choice(Parsers... ps) {
   return
       [ps...](str_pos &pos) { return detail::apply_parser_choice(pos, ps...); };
 }
 
-template <typename P, typename F> static auto map(P p, F f) {
+// Like choice(), but alternatives with a known FIRST set (oneOf, noneOf,
+// sat with a char_class, const_string, number, with_first_set, ...) that
+// cannot match the next character are skipped via a lookup table.
+// Constructing it fills that 256 entry table, so build it once, e.g. as a
+// static or a rule, and not on every call of a parser function.
+template <typename... Parsers>
+static constexpr auto choice_first(Parsers... ps) {
+  static_assert(sizeof...(Parsers) <= 64, "at most 64 alternatives");
+  return detail::dispatch_choice<Parsers...>{ps...};
+}
+
+template <typename P, typename F> static constexpr auto map(P p, F f) {
   return
       [p, f](str_pos &pos)
           -> parser<typename std::result_of<F(parser_payload_type<P>)>::type> {
@@ -374,18 +1412,83 @@ template <typename P, typename F> static auto map(P p, F f) {
       };
 }
 
+// A parser with payload T that can be declared before it is defined, so
+// rules of a grammar can refer to each other and to themselves:
+//
+//   rule<int> factor;
+//   const auto sum{chainl1(factor, add_op)};
+//   factor = choice(integer, clasped(oneOf('('), oneOf(')'), sum));
+//
+// Copies of a rule, e.g. the ones captured by other combinators, share the
+// definition with the original and keep it alive, so rules may be returned
+// from functions and outlive the original. Defining a copy defines the
+// original. A recursive rule's definition holds a copy of the rule itself
+// and is therefore never freed, so build such grammars once.
+// The combinators of a definition are built once, and running a rule is one
+// indirect call into them.
+template <typename T> class rule {
+  struct definition_base {
+    virtual ~definition_base() = default;
+    virtual parser<T> parse(str_pos &pos) const = 0;
+  };
+
+  template <typename Parser> struct definition : definition_base {
+    Parser p;
+    explicit definition(Parser p_) : p{std::move(p_)} {}
+    parser<T> parse(str_pos &pos) const override { return p(pos); }
+  };
+
+  std::shared_ptr<std::unique_ptr<definition_base>> def{
+      std::make_shared<std::unique_ptr<definition_base>>()};
+
+public:
+  rule() = default;
+  rule(const rule &) = default;
+  rule &operator=(const rule &) = delete;
+
+  template <typename Parser,
+            typename = std::enable_if_t<
+                !std::is_same_v<std::decay_t<Parser>, rule>>>
+  rule &operator=(Parser p) {
+    *def = std::make_unique<definition<Parser>>(std::move(p));
+    return *this;
+  }
+
+  parser<T> operator()(str_pos &pos) const {
+    assert(*def && "rule used before it was defined");
+    return (*def)->parse(pos);
+  }
+};
+
+// The input can be anything str_pos is constructible from: std::string,
+// std::string_view, string literals, std::span<const char>, or an explicit
+// str_pos{data, size} over any other contiguous buffer.
+// The input is not copied, so it must outlive the returned position.
 template <typename Parser>
-static auto run_parser(Parser &&p, const std::string &s)
+static constexpr auto run_parser(Parser &&p, str_pos pos)
     -> std::pair<parser_ret<Parser>, str_pos> {
-  str_pos pos{s};
   return {p(pos), pos};
 }
 
 template <typename Parser>
-static auto parse_result(Parser &&p,
-                         const std::string &s) -> parser_ret<Parser> {
-  str_pos pos{s};
+static constexpr auto parse_result(Parser &&p, str_pos pos)
+    -> parser_ret<Parser> {
   return p(pos);
 }
 
+// Parses pos into out and returns whether p succeeded. Filling parsers like
+// manyV_into() write to out directly. The payload of any other parser is
+// assigned to out.
+template <typename Parser, typename Out>
+static bool parse_into(Parser &&p, str_pos pos, Out &out) {
+  if constexpr (std::is_invocable_v<Parser &, str_pos &, Out &>) {
+    return !!p(pos, out);
+  } else if (auto ret{p(pos)}) {
+    out = std::move(*ret);
+    return true;
+  } else {
+    return false;
+  }
+}
+
 } // namespace apl
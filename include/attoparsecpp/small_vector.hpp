@@ -0,0 +1,216 @@
+#pragma once
+
+#include "parser.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+ * Containers for short repetitions: manyV_small<N> and sep_by_small<N> work
+ * like manyV and sep_by, but return a small_vector<T, N>, which stores up to
+ * N items inside the object and only allocates when it grows beyond that.
+ * Argument lists and short tuples then cost no heap allocation at all.
+ *
+ *   const auto args{sep_by_small<8>(token(integer), token(oneOf(',')))};
+ */
+
+namespace apl {
+
+// Vector with N inline slots. Elements move to the heap, in a buffer that
+// doubles its capacity, when they do not fit any longer. Moving a
+// small_vector moves its elements one by one while they are inline and
+// takes over the heap buffer otherwise.
+template <typename T, size_t N> class small_vector {
+  static_assert(N > 0, "small_vector needs at least one inline slot");
+
+  alignas(T) std::byte storage[N * sizeof(T)];
+  T *data_{reinterpret_cast<T *>(storage)};
+  size_t size_{0};
+  size_t capacity_{N};
+
+  T *inline_data() { return reinterpret_cast<T *>(storage); }
+
+  // Moves the elements into a heap buffer with room for new_capacity items.
+  void grow(size_t new_capacity) {
+    T *const heap{std::allocator<T>{}.allocate(new_capacity)};
+    std::uninitialized_move(begin(), end(), heap);
+    std::destroy(begin(), end());
+    release();
+    data_ = heap;
+    capacity_ = new_capacity;
+  }
+
+  // Frees the heap buffer, if any, after its elements have been destroyed.
+  void release() {
+    if (!is_inline()) {
+      std::allocator<T>{}.deallocate(data_, capacity_);
+      data_ = inline_data();
+      capacity_ = N;
+    }
+  }
+
+  void take(small_vector &&other) {
+    if (other.is_inline()) {
+      std::uninitialized_move(other.begin(), other.end(), data_);
+      size_ = other.size_;
+      other.clear();
+      return;
+    }
+    data_ = other.data_;
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    other.data_ = other.inline_data();
+    other.size_ = 0;
+    other.capacity_ = N;
+  }
+
+public:
+  using value_type = T;
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  small_vector() = default;
+
+  small_vector(std::initializer_list<T> items) {
+    reserve(items.size());
+    for (const auto &item : items) {
+      emplace_back(item);
+    }
+  }
+
+  small_vector(const small_vector &other) {
+    reserve(other.size_);
+    std::uninitialized_copy(other.begin(), other.end(), data_);
+    size_ = other.size_;
+  }
+
+  small_vector(small_vector &&other) noexcept(
+      std::is_nothrow_move_constructible_v<T>) {
+    take(std::move(other));
+  }
+
+  small_vector &operator=(const small_vector &other) {
+    if (this != &other) {
+      clear();
+      reserve(other.size_);
+      std::uninitialized_copy(other.begin(), other.end(), data_);
+      size_ = other.size_;
+    }
+    return *this;
+  }
+
+  small_vector &operator=(small_vector &&other) noexcept(
+      std::is_nothrow_move_constructible_v<T>) {
+    if (this != &other) {
+      clear();
+      release();
+      take(std::move(other));
+    }
+    return *this;
+  }
+
+  ~small_vector() {
+    clear();
+    release();
+  }
+
+  template <typename... Args> T &emplace_back(Args &&...args) {
+    if (size_ == capacity_) {
+      // The arguments may refer to elements, which grow() moves.
+      T item(std::forward<Args>(args)...);
+      grow(2 * capacity_);
+      return emplace_back(std::move(item));
+    }
+    T *const item{::new (static_cast<void *>(data_ + size_))
+                      T(std::forward<Args>(args)...)};
+    ++size_;
+    return *item;
+  }
+
+  void push_back(const T &item) { emplace_back(item); }
+  void push_back(T &&item) { emplace_back(std::move(item)); }
+
+  void reserve(size_t n) {
+    if (n > capacity_) {
+      grow(n);
+    }
+  }
+
+  // Destroys the elements but keeps the capacity.
+  void clear() {
+    std::destroy(begin(), end());
+    size_ = 0;
+  }
+
+  // True as long as the elements are stored inside the object.
+  bool is_inline() const {
+    return data_ == reinterpret_cast<const T *>(storage);
+  }
+
+  size_t size() const { return size_; }
+  size_t capacity() const { return capacity_; }
+  bool empty() const { return size_ == 0; }
+
+  T *data() { return data_; }
+  const T *data() const { return data_; }
+
+  iterator begin() { return data_; }
+  iterator end() { return data_ + size_; }
+  const_iterator begin() const { return data_; }
+  const_iterator end() const { return data_ + size_; }
+
+  T &operator[](size_t i) { return data_[i]; }
+  const T &operator[](size_t i) const { return data_[i]; }
+
+  T &front() { return data_[0]; }
+  T &back() { return data_[size_ - 1]; }
+  const T &front() const { return data_[0]; }
+  const T &back() const { return data_[size_ - 1]; }
+
+  bool operator==(const small_vector &o) const {
+    return std::equal(begin(), end(), o.begin(), o.end());
+  }
+  bool operator!=(const small_vector &o) const { return !(*this == o); }
+};
+
+template <size_t N, typename Parser, typename T = parser_payload_type<Parser>>
+static auto manyV_small(Parser p, bool minimum_one = false) {
+  return [p, minimum_one](str_pos &pos) -> parser<small_vector<T, N>> {
+    small_vector<T, N> v;
+    while (auto ret{p(pos)}) {
+      v.emplace_back(std::move(*ret));
+    }
+    if (minimum_one && v.empty()) {
+      return {};
+    }
+    return {std::move(v)};
+  };
+}
+
+template <size_t N, typename TParser, typename SepParser,
+          typename T = parser_payload_type<TParser>>
+static auto sep_by_small(TParser item_parser, SepParser sep_parser,
+                         bool minimum_one = false) {
+  return [item_parser, sep_parser,
+          minimum_one](str_pos &pos) -> parser<small_vector<T, N>> {
+    small_vector<T, N> v;
+    while (auto ret{item_parser(pos)}) {
+      v.emplace_back(std::move(*ret));
+      auto sep_ret{sep_parser(pos)};
+      if (!sep_ret) {
+        break;
+      }
+    }
+    if (minimum_one && v.empty()) {
+      return {};
+    }
+    return {std::move(v)};
+  };
+}
+
+} // namespace apl
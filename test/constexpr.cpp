@@ -0,0 +1,69 @@
+#include <attoparsecpp/parser.hpp>
+
+#include <string_view>
+#include <tuple>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace apl;
+using namespace std::string_view_literals;
+
+// Everything in here is checked by the compiler, the scenario only makes the
+// file show up in the test report.
+
+static_assert(parse_result(anyChar, "x") == 'x');
+static_assert(!parse_result(anyChar, ""));
+static_assert(parse_result(sat(digit_class), "7") == '7');
+static_assert(parse_result(sat([](char c) { return c == 'a'; }), "a") == 'a');
+static_assert(parse_result(oneOf('a', 'b'), "b") == 'b');
+static_assert(!parse_result(noneOf('a', 'b'), "b"));
+
+static_assert(parse_result(many_view(oneOf('a')), "aaab") == "aaa"sv);
+static_assert(parse_result(many1_view(number), "123x") == "123"sv);
+static_assert(!parse_result(many1_view(number), "x"));
+static_assert(parse_result(take_while(alpha_class), "abc1") == "abc"sv);
+static_assert(run_parser(skip_many(oneOf(' ')), "   x").second.size() == 1);
+static_assert(parse_result(const_string_view("GET"), "GET /") == "GET"sv);
+static_assert(parse_result(skip_string("GET"), "GET /") == unit{});
+
+static_assert(!parse_result(base_integer(10), "12345678901"));
+static_assert(parse_result(base_integer<int64_t>(10), "12345678901") ==
+              12345678901);
+static_assert(parse_result(base_integer(16), "ff") == 255);
+static_assert(parse_result(integer, "0x1F") == 31);
+static_assert(!parse_result(base_integer<uint8_t>(10), "256"));
+static_assert(parse_result(many_count(token(integer)), "1 2 3") == 3);
+static_assert(parse_result(sep_by_fold(integer, oneOf(','), 0,
+                                       [](int a, int b) { return a + b; }),
+                           "1,2,3") == 6);
+
+static_assert(parse_result(tuple_of(integer, prefixed(oneOf(':'), integer)),
+                           "80:443") == std::tuple{80, 443});
+static_assert(parse_result(choice(const_string_view("GET"),
+                                  const_string_view("PUT")),
+                           "PUT") == "PUT"sv);
+static_assert(parse_result(choice(oneOf('a'), oneOf('b')), "b") == 'b');
+static_assert(parse_result(map(integer, [](int i) { return i * 2; }), "21") ==
+              42);
+static_assert(parse_result(clasped(oneOf('['), oneOf(']'), integer), "[5]") ==
+              5);
+static_assert(!parse_result(attempt(postfixed(oneOf('!'), integer)), "5?"));
+
+// A compile time checked config value: "<number><unit>".
+static constexpr auto duration_ms{[](std::string_view s) {
+  const auto unit_factor{choice(map(const_string_view("ms"), [](auto) {
+                                  return 1;
+                                }),
+                                map(oneOf('s'), [](char) { return 1000; }))};
+  const auto p{tuple_of(integer, unit_factor)};
+  const auto r{parse_result(p, s)};
+  return r ? std::get<0>(*r) * std::get<1>(*r) : -1;
+}};
+
+static_assert(duration_ms("250ms") == 250);
+static_assert(duration_ms("3s") == 3000);
+static_assert(duration_ms("3h") == -1);
+
+SCENARIO("constexpr parsers", "[constexpr]") {
+  REQUIRE(duration_ms("3s") == 3000);
+}
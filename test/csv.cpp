@@ -0,0 +1,57 @@
+#include <attoparsecpp/csv.hpp>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace apl;
+
+namespace {
+
+using rows = std::vector<std::vector<std::string>>;
+
+// Copies all rows, because the field views are only valid during the
+// callback.
+std::optional<rows> rows_of(std::string_view input, char delimiter = ',') {
+  rows r;
+  const bool ok{parse_csv(
+      input,
+      [&r](const std::vector<std::string_view> &fields) {
+        r.emplace_back(fields.begin(), fields.end());
+      },
+      delimiter)};
+  if (!ok) {
+    return {};
+  }
+  return r;
+}
+
+} // namespace
+
+SCENARIO("csv parser", "[csv]") {
+  GIVEN("unquoted fields") {
+    REQUIRE(rows_of("") == rows{});
+    REQUIRE(rows_of("a") == rows{{"a"}});
+    REQUIRE(rows_of("a,b\nc,d\n") == rows{{"a", "b"}, {"c", "d"}});
+    REQUIRE(rows_of("a,b\r\nc,d") == rows{{"a", "b"}, {"c", "d"}});
+    REQUIRE(rows_of(",\n\n") == rows{{"", ""}, {""}});
+    REQUIRE(rows_of("1;2.5;x", ';') == rows{{"1", "2.5", "x"}});
+  }
+  GIVEN("quoted fields") {
+    REQUIRE(rows_of("\"a,b\",c") == rows{{"a,b", "c"}});
+    REQUIRE(rows_of("\"line\r\nbreak\"\r\n") == rows{{"line\r\nbreak"}});
+    REQUIRE(rows_of("\"\"") == rows{{""}});
+    REQUIRE(rows_of("\"say \"\"hi\"\"\",\"\"\"\"") ==
+            rows{{"say \"hi\"", "\""}});
+    REQUIRE(rows_of("\"a\"\"\",\"b\"\"\"\n\"c\"") ==
+            rows{{"a\"", "b\""}, {"c"}});
+  }
+  GIVEN("malformed input") {
+    REQUIRE(!rows_of("\"abc"));
+    REQUIRE(!rows_of("\"abc\"\""));
+    REQUIRE(!rows_of("\"a\"b,c"));
+    REQUIRE(!rows_of("a\rb"));
+  }
+}
@@ -0,0 +1,235 @@
+#include <attoparsecpp/gdb_remote.hpp>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace apl;
+
+namespace {
+
+using kind = gdb_message_kind;
+using messages = std::vector<std::pair<kind, std::string>>;
+
+// Feeds input in chunks of chunk_size bytes and copies all messages,
+// because the payload views are only valid during the callback.
+messages stream_of(std::string_view input, size_t chunk_size,
+                   bool *partial = nullptr,
+                   size_t max_payload = gdb_max_payload) {
+  messages m;
+  gdb_stream stream{max_payload};
+  for (size_t i{0}; i < input.size(); i += chunk_size) {
+    stream.feed(input.substr(i, chunk_size), [&m](const gdb_message &msg) {
+      m.emplace_back(msg.kind, std::string{msg.payload});
+    });
+  }
+  if (partial) {
+    *partial = stream.partial();
+  }
+  return m;
+}
+
+// A packet with a correct checksum.
+std::string packet(std::string_view payload) {
+  static constexpr char hex[]{"0123456789abcdef"};
+  uint8_t sum{0};
+  for (const char c : payload) {
+    sum = static_cast<uint8_t>(sum + static_cast<uint8_t>(c));
+  }
+  return "$" + std::string{payload} + "#" + hex[sum >> 4] + hex[sum & 0xf];
+}
+
+} // namespace
+
+SCENARIO("gdb remote messages", "[gdb_remote]") {
+  GIVEN("single messages") {
+    REQUIRE(!run_parser(gdb_message_parser, "").first);
+    REQUIRE(run_parser(gdb_message_parser, "+").first ==
+            gdb_message{kind::ack, {}});
+    REQUIRE(run_parser(gdb_message_parser, "-").first ==
+            gdb_message{kind::nack, {}});
+    REQUIRE(run_parser(gdb_message_parser, "\x03").first ==
+            gdb_message{kind::interrupt, {}});
+    REQUIRE(run_parser(gdb_message_parser, "x").first == std::nullopt);
+  }
+  GIVEN("packets") {
+    REQUIRE(run_parser(gdb_message_parser, "$#00").first ==
+            gdb_message{kind::packet, ""});
+    REQUIRE(run_parser(gdb_message_parser, "$vMustReplyEmpty#3a").first ==
+            gdb_message{kind::packet, "vMustReplyEmpty"});
+    REQUIRE(run_parser(gdb_message_parser, "$vMustReplyEmpty#3A").first ==
+            gdb_message{kind::packet, "vMustReplyEmpty"});
+    REQUIRE(run_parser(gdb_message_parser, "$vMustReplyEmpty#3b").first ==
+            gdb_message{kind::bad_checksum, "vMustReplyEmpty"});
+    REQUIRE(run_parser(gdb_message_parser, "$g#zz").first ==
+            gdb_message{kind::bad_checksum, "g"});
+  }
+  GIVEN("long packets") {
+    std::string payload;
+    for (int i{0}; i < 1000; ++i) {
+      payload += "0123456789abcdef"[(i * 7) % 16];
+    }
+    const auto msg{packet(payload)};
+    const auto r{run_parser(gdb_message_parser, msg)};
+    REQUIRE(r.first == gdb_message{kind::packet, payload});
+    REQUIRE(r.second.at_end());
+  }
+  GIVEN("a packet interrupted by another one") {
+    const auto r{run_parser(gdb_message_parser, "$abc$g#67")};
+    REQUIRE(!r.first);
+    REQUIRE(r.second.size() == 9);
+  }
+  GIVEN("incomplete packets") {
+    for (const auto s : {"$", "$g", "$g#", "$g#6"}) {
+      const auto r{run_parser(gdb_message_parser, s)};
+      REQUIRE(!r.first);
+      REQUIRE(r.second.size() == std::string_view{s}.size());
+    }
+  }
+  GIVEN("payloads are views of the input") {
+    const std::string input{"$m1000,4#8e"};
+    str_pos pos{input};
+    const auto r{gdb_message_parser(pos)};
+    REQUIRE(!!r);
+    REQUIRE(r->payload.data() == input.data() + 1);
+  }
+}
+
+SCENARIO("gdb remote streams", "[gdb_remote]") {
+  std::string payload;
+  for (int i{0}; i < 100; ++i) {
+    payload += "deadbeef";
+  }
+  const std::string input{"+" + packet("qSupported") + "-\x03" +
+                          "noise" + packet(payload) + "$g#00" + "+"};
+  const messages expected{{kind::ack, ""},
+                          {kind::packet, "qSupported"},
+                          {kind::nack, ""},
+                          {kind::interrupt, ""},
+                          {kind::packet, payload},
+                          {kind::bad_checksum, "g"},
+                          {kind::ack, ""}};
+
+  GIVEN("the whole stream at once") {
+    bool partial{true};
+    REQUIRE(stream_of(input, input.size(), &partial) == expected);
+    REQUIRE(!partial);
+  }
+  GIVEN("the stream split at every possible chunk size") {
+    for (size_t size{1}; size < input.size(); ++size) {
+      bool partial{true};
+      REQUIRE(stream_of(input, size, &partial) == expected);
+      REQUIRE(!partial);
+    }
+  }
+  GIVEN("packets that are interrupted by a $") {
+    std::string broken{"$qSupported:multiprocess+;swbreak+"};
+    broken += std::string(40, 'x');
+    const std::string s{"+" + broken + packet("g") + "$m10" + packet("c") +
+                        "+"};
+    const messages m{{kind::ack, ""},
+                     {kind::packet, "g"},
+                     {kind::packet, "c"},
+                     {kind::ack, ""}};
+    for (size_t size{1}; size <= s.size(); ++size) {
+      bool partial{true};
+      REQUIRE(stream_of(s, size, &partial) == m);
+      REQUIRE(!partial);
+    }
+  }
+  GIVEN("packets longer than the payload limit") {
+    const std::string s{packet(std::string(64, 'a')) + "+" +
+                        packet(std::string(32, 'b')) + packet("g") +
+                        packet(std::string(100, 'c') + "+-\x03") + "-"};
+    const messages m{{kind::oversized, ""},
+                     {kind::ack, ""},
+                     {kind::packet, std::string(32, 'b')},
+                     {kind::packet, "g"},
+                     {kind::oversized, ""},
+                     {kind::nack, ""}};
+    for (size_t size{1}; size <= s.size(); ++size) {
+      bool partial{true};
+      REQUIRE(stream_of(s, size, &partial, 32) == m);
+      REQUIRE(!partial);
+    }
+  }
+  GIVEN("a stream that ends within a packet") {
+    bool partial{false};
+    REQUIRE(stream_of("+$qC#", 2, &partial) == messages{{kind::ack, ""}});
+    REQUIRE(partial);
+  }
+}
+
+SCENARIO("gdb remote payload decoding", "[gdb_remote]") {
+  using bytes = std::vector<uint8_t>;
+  // Long enough for the vectorized paths, with all hex digit cases.
+  std::string hex;
+  bytes decoded;
+  for (int i{0}; i < 100; ++i) {
+    const auto b{static_cast<uint8_t>(i * 37 + 11)};
+    hex += "0123456789abcdef"[b >> 4];
+    hex += "0123456789ABCDEF"[b & 0xf];
+    decoded.push_back(b);
+  }
+
+  GIVEN("hex encoded data") {
+    bytes out;
+    REQUIRE(run_parser(gdb_hex_bytes(out), "").first == 0u);
+    REQUIRE(run_parser(gdb_hex_bytes(out), "00ff7A").first == 3u);
+    REQUIRE(out == bytes{0x00, 0xff, 0x7a});
+    auto r{run_parser(gdb_hex_bytes(out), hex)};
+    REQUIRE(r.first == decoded.size());
+    REQUIRE(r.second.at_end());
+    REQUIRE(out == decoded);
+
+    WHEN("the digits end early") {
+      for (const size_t n : {size_t{1}, size_t{17}, size_t{33}, size_t{150}}) {
+        std::string s{hex};
+        s[n] = 'g';
+        r = run_parser(gdb_hex_bytes(out), s);
+        REQUIRE(r.first == n / 2);
+        REQUIRE(r.second.size() == s.size() - n / 2 * 2);
+        REQUIRE(out == bytes(decoded.begin(), decoded.begin() + n / 2));
+      }
+      r = run_parser(gdb_hex_bytes(out), "abc");
+      REQUIRE(r.first == 1u);
+      REQUIRE(r.second.size() == 1);
+    }
+  }
+
+  GIVEN("escaped binary data") {
+    bytes out;
+    REQUIRE(run_parser(gdb_binary_bytes(out), "").first == 0u);
+    REQUIRE(run_parser(gdb_binary_bytes(out), "ab}]").first == 3u);
+    REQUIRE(out == bytes{'a', 'b', '}'});
+    REQUIRE(!run_parser(gdb_binary_bytes(out), "ab}").first);
+
+    std::string escaped;
+    bytes binary;
+    for (int i{0}; i < 300; ++i) {
+      const auto b{static_cast<uint8_t>(i * 7)};
+      binary.push_back(b);
+      if (b == '}' || b == '#' || b == '$' || b == '*') {
+        escaped += '}';
+        escaped += static_cast<char>(b ^ 0x20);
+      } else {
+        escaped += static_cast<char>(b);
+      }
+    }
+    auto r{run_parser(gdb_binary_bytes(out), escaped + "#00")};
+    REQUIRE(r.first == binary.size());
+    REQUIRE(out == binary);
+    REQUIRE(r.second.size() == 3);
+  }
+
+  GIVEN("one buffer for many payloads") {
+    bytes out;
+    const auto hex_data{gdb_hex_bytes(out)};
+    REQUIRE(run_parser(hex_data, hex).first == decoded.size());
+    REQUIRE(run_parser(hex_data, "0102").first == 2u);
+    REQUIRE(out == bytes{1, 2});
+  }
+}
@@ -0,0 +1,98 @@
+#include <attoparsecpp/incremental.hpp>
+
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace apl;
+
+SCENARIO("incremental parser", "[incremental]") {
+  GIVEN("an integer parser") {
+    incremental p{base_integer<int64_t>(10)};
+    WHEN("the number is split across chunks") {
+      REQUIRE(p.feed("12") == incremental_status::partial);
+      REQUIRE(p.feed("34") == incremental_status::partial);
+      REQUIRE(p.feed("5 rest") == incremental_status::done);
+      REQUIRE(p.result() == 12345);
+      REQUIRE(p.rest() == " rest");
+    }
+    WHEN("the input ends right after the number") {
+      REQUIRE(p.feed("12") == incremental_status::partial);
+      REQUIRE(p.finish() == incremental_status::done);
+      REQUIRE(p.result() == 12);
+      REQUIRE(p.rest().empty());
+    }
+    WHEN("the input is no number") {
+      REQUIRE(p.feed("x") == incremental_status::partial);
+      REQUIRE(p.finish() == incremental_status::failed);
+    }
+    WHEN("a long number arrives in many chunks") {
+      REQUIRE(p.feed("1") == incremental_status::partial);
+      for (int i{0}; i < 17; ++i) {
+        REQUIRE(p.feed("0") == incremental_status::partial);
+      }
+      // The space completes the number without waiting for finish().
+      REQUIRE(p.feed(" ") == incremental_status::done);
+      REQUIRE(p.result() == 100000000000000000);
+      REQUIRE(p.rest() == " ");
+    }
+  }
+}
+
+SCENARIO("incremental item parser", "[incremental]") {
+  const auto line{postfixed(oneOf('\n'), sep_by(integer, oneOf(',')))};
+  std::vector<std::vector<int>> lines;
+  const auto collect{[&lines](std::vector<int> v) {
+    lines.push_back(std::move(v));
+  }};
+
+  GIVEN("lines split at arbitrary positions") {
+    incremental_items p{line, collect};
+    REQUIRE(p.feed("1,2") == incremental_status::partial);
+    REQUIRE(lines.empty());
+    REQUIRE(p.feed(",3\n4,") == incremental_status::partial);
+    REQUIRE(lines == std::vector<std::vector<int>>{{1, 2, 3}});
+    REQUIRE(p.rest() == "4,");
+    REQUIRE(p.feed("5\n6\n") == incremental_status::partial);
+    REQUIRE(lines.size() == 2);
+    REQUIRE(p.finish() == incremental_status::done);
+    REQUIRE(lines == std::vector<std::vector<int>>{{1, 2, 3}, {4, 5}, {6}});
+  }
+  GIVEN("items that are complete at the end of a chunk") {
+    incremental_items p{line, collect, true};
+    REQUIRE(p.feed("1,2\n") == incremental_status::partial);
+    REQUIRE(lines == std::vector<std::vector<int>>{{1, 2}});
+  }
+  GIVEN("a malformed item in the middle of the stream") {
+    incremental_items p{line, collect, false, 4};
+    REQUIRE(p.feed("1\nx\n") == incremental_status::partial);
+    REQUIRE(lines == std::vector<std::vector<int>>{{1}});
+    WHEN("the stream ends") {
+      REQUIRE(p.finish() == incremental_status::failed);
+      REQUIRE(p.rest() == "x\n");
+    }
+    WHEN("more input than an item may hold follows") {
+      REQUIRE(p.feed("2\n3\n") == incremental_status::failed);
+      REQUIRE(p.feed("5\n") == incremental_status::failed);
+      REQUIRE(lines == std::vector<std::vector<int>>{{1}});
+    }
+  }
+  GIVEN("a keyword that is split across chunks") {
+    size_t keywords{0};
+    incremental_items p{postfixed(oneOf('\n'), skip_string("keyword")),
+                        [&keywords](unit) { ++keywords; }, true};
+    REQUIRE(p.feed("keyword\nkey") == incremental_status::partial);
+    REQUIRE(keywords == 1);
+    REQUIRE(p.feed("word\n") == incremental_status::partial);
+    REQUIRE(keywords == 2);
+    REQUIRE(p.finish() == incremental_status::done);
+  }
+  GIVEN("a stream that ends within an item") {
+    incremental_items p{line, collect};
+    REQUIRE(p.feed("1\n2") == incremental_status::partial);
+    REQUIRE(p.finish() == incremental_status::failed);
+    REQUIRE(lines == std::vector<std::vector<int>>{{1}});
+    REQUIRE(p.rest() == "2");
+  }
+}
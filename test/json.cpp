@@ -0,0 +1,113 @@
+#include <attoparsecpp/json.hpp>
+
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace apl;
+
+namespace {
+
+// Writes every event as a short token, so tests can compare whole sequences.
+struct recorder : json_handler {
+  std::string events;
+
+  void null() { events += "null "; }
+  void boolean(bool b) { events += b ? "true " : "false "; }
+  void integer(int64_t i) { events += "i" + std::to_string(i) + " "; }
+  void number(double d) { events += "d" + std::to_string(d) + " "; }
+  void string(std::string_view s) { events += "s:" + std::string{s} + " "; }
+  void key(std::string_view k) { events += "k:" + std::string{k} + " "; }
+  void start_object() { events += "{ "; }
+  void end_object() { events += "} "; }
+  void start_array() { events += "[ "; }
+  void end_array() { events += "] "; }
+};
+
+std::string events_of(std::string_view input) {
+  recorder r;
+  if (!parse_json(input, r)) {
+    return "error";
+  }
+  return r.events;
+}
+
+} // namespace
+
+SCENARIO("json parser", "[json]") {
+  GIVEN("scalar documents") {
+    REQUIRE(events_of("null") == "null ");
+    REQUIRE(events_of(" true ") == "true ");
+    REQUIRE(events_of("false") == "false ");
+    REQUIRE(events_of("\"abc\"") == "s:abc ");
+  }
+  GIVEN("numbers") {
+    REQUIRE(events_of("0") == "i0 ");
+    REQUIRE(events_of("-42") == "i-42 ");
+    REQUIRE(events_of("1.5") == "d1.500000 ");
+    REQUIRE(events_of("-2e3") == "d-2000.000000 ");
+    REQUIRE(events_of("1E-1") == "d0.100000 ");
+    REQUIRE(events_of("9223372036854775807") == "i9223372036854775807 ");
+    REQUIRE(events_of("18446744073709551616") ==
+            "d18446744073709551616.000000 ");
+    REQUIRE(events_of("01") == "error");
+    REQUIRE(events_of("1.") == "error");
+    REQUIRE(events_of("1e") == "error");
+    REQUIRE(events_of("-") == "error");
+    REQUIRE(events_of("+1") == "error");
+  }
+  GIVEN("nested containers") {
+    REQUIRE(events_of("[]") == "[ ] ");
+    REQUIRE(events_of("{ }") == "{ } ");
+    REQUIRE(events_of(R"({"a": [1, {"b": null}], "c" : "d"})") ==
+            "{ k:a [ i1 { k:b null } ] k:c s:d } ");
+    REQUIRE(events_of(" [ [ ] , [ 1 ] ] \n") == "[ [ ] [ i1 ] ] ");
+  }
+  GIVEN("strings with escape sequences") {
+    REQUIRE(events_of(R"("a\"b\\c\/d\n")") == "s:a\"b\\c/d\n ");
+    REQUIRE(events_of(R"("\u00e4\u20AC")") == "s:\xc3\xa4\xe2\x82\xac ");
+    REQUIRE(events_of(R"("\ud83d\ude00")") == "s:\xf0\x9f\x98\x80 ");
+    REQUIRE(events_of(R"({"\t": 1})") == "{ k:\t i1 } ");
+    REQUIRE(events_of(R"("\x")") == "error");
+    REQUIRE(events_of(R"("\u12")") == "error");
+    REQUIRE(events_of(R"("\ud83d")") == "error");
+    REQUIRE(events_of(R"("\ude00")") == "error");
+  }
+  GIVEN("malformed documents") {
+    REQUIRE(events_of("") == "error");
+    REQUIRE(events_of("[1,]") == "error");
+    REQUIRE(events_of("[1 2]") == "error");
+    REQUIRE(events_of(R"({"a" 1})") == "error");
+    REQUIRE(events_of(R"({"a": 1,})") == "error");
+    REQUIRE(events_of(R"({1: 1})") == "error");
+    REQUIRE(events_of("\"abc") == "error");
+    REQUIRE(events_of("[1] x") == "error");
+    REQUIRE(events_of("nul") == "error");
+  }
+  GIVEN("control characters in strings") {
+    REQUIRE(events_of("\"a\tb\"") == "error");
+    REQUIRE(events_of("\"a\\nb\nc\"") == "error");
+    REQUIRE(events_of(std::string{"\"a\0b\"", 5}) == "error");
+    REQUIRE(events_of("\"0123456789abcdef\x1f\"") == "error");
+    REQUIRE(events_of("\"0123456789abcdef\x7f\xc3\xa4\"") ==
+            "s:0123456789abcdef\x7f\xc3\xa4 ");
+  }
+  GIVEN("deeply nested containers") {
+    const auto nested{[](size_t n) {
+      return std::string(n, '[') + std::string(n, ']');
+    }};
+    REQUIRE(events_of(nested(json_max_depth)) != "error");
+    REQUIRE(events_of(nested(json_max_depth + 1)) == "error");
+    REQUIRE(events_of(std::string(200000, '[')) == "error");
+    std::string objects;
+    for (size_t i{0}; i < 100000; ++i) {
+      objects += R"({"a":)";
+    }
+    REQUIRE(events_of(objects) == "error");
+  }
+  GIVEN("a document after one that failed deep inside") {
+    REQUIRE(events_of(std::string(json_max_depth, '[') + "x") == "error");
+    const std::string nested(json_max_depth, '[');
+    REQUIRE(events_of(nested + std::string(json_max_depth, ']')) != "error");
+  }
+}
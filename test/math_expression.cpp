@@ -142,3 +142,19 @@ SCENARIO("math expression parser", "[math_expression_parser]") {
     }
   }
 }
+
+SCENARIO("term and factor parsers", "[math_expression_parser]") {
+  GIVEN("factor") {
+    REQUIRE(parse_result(factor, "42") == 42);
+    REQUIRE(parse_result(factor, "(1 + 2)") == 3);
+    const auto r{run_parser(factor, "2 * 3")};
+    REQUIRE(r.first == 2);
+    REQUIRE(r.second.size() == 4);
+  }
+  GIVEN("term") {
+    REQUIRE(parse_result(term, "2 * 3 / 2") == 3);
+    const auto r{run_parser(term, "2 * 3 + 1")};
+    REQUIRE(r.first == 6);
+    REQUIRE(r.second.peek() == '+');
+  }
+}
@@ -0,0 +1,50 @@
+#include <attoparsecpp/memo.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace apl;
+using namespace std::string_literals;
+
+static size_t digit_calls{0};
+
+static parser<char> counted_digit(str_pos &pos) {
+  ++digit_calls;
+  return number(pos);
+}
+
+SCENARIO("memo parser", "[memo]") {
+  const auto digit{memo(counted_digit)};
+  const auto p{choice(attempt(tuple_of(digit, oneOf('+'))),
+                      attempt(tuple_of(digit, oneOf('-'))),
+                      tuple_of(digit, oneOf('*')))};
+  GIVEN("no memo table") {
+    digit_calls = 0;
+    const auto r{parse_result(p, "1*")};
+    REQUIRE(r == std::make_tuple('1', '*'));
+    REQUIRE(digit_calls == 3);
+  }
+  GIVEN("a memo table") {
+    memo_table table;
+    digit_calls = 0;
+    const auto r{parse_result(p, "1*", table)};
+    REQUIRE(r == std::make_tuple('1', '*'));
+    REQUIRE(digit_calls == 1);
+
+    WHEN("reusing the table for other input at the same address") {
+      std::string s{"2-"};
+      REQUIRE(parse_result(p, s, table) == std::make_tuple('2', '-'));
+      s = "x-";
+      const auto r2{run_parser(p, s, table)};
+      REQUIRE(!r2.first);
+    }
+  }
+  GIVEN("a memoized rule that fails") {
+    memo_table table;
+    const memo_scope scope{table};
+    const std::string s{"a"};
+    str_pos pos{s};
+    REQUIRE(!digit(pos));
+    REQUIRE(!digit(pos));
+    REQUIRE(pos.size() == 1);
+  }
+}
@@ -0,0 +1,54 @@
+#include <attoparsecpp/parallel.hpp>
+
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace apl;
+
+SCENARIO("parallel record parsing", "[parallel]") {
+  const auto line{sep_by_fold(integer, oneOf(','), 0,
+                              [](int a, int b) { return a + b; }, true)};
+  GIVEN("an empty buffer") {
+    const auto r{parallel_parse_records(line, "", '\n', 4)};
+    REQUIRE(r.results.empty());
+    REQUIRE(r.failures.empty());
+  }
+  GIVEN("a few records, some of them broken") {
+    const auto r{parallel_parse_records(line, "1,2\nx\n3\n\n4,5", '\n', 4)};
+    REQUIRE(r.results.size() == 5);
+    REQUIRE(r.results[0] == 3);
+    REQUIRE(r.results[2] == 3);
+    REQUIRE(r.results[4] == 9);
+    REQUIRE(r.failures == std::vector<size_t>{1, 3});
+  }
+  GIVEN("records with trailing input") {
+    const auto r{parallel_parse_records(line, "1,2\n12abc\n3,4 ", '\n', 4)};
+    REQUIRE(r.results.size() == 3);
+    REQUIRE(r.results[0] == 3);
+    REQUIRE(!r.results[1]);
+    REQUIRE(!r.results[2]);
+    REQUIRE(r.failures == std::vector<size_t>{1, 2});
+  }
+  GIVEN("a buffer that is cut into many chunks") {
+    std::string s;
+    for (int i{0}; i < 100000; ++i) {
+      s += i % 1000 == 999 ? "-" : std::to_string(i) + ",1";
+      s += ';';
+    }
+    for (size_t threads : {1, 3, 8}) {
+      const auto r{parallel_parse_records(line, s, ';', threads)};
+      REQUIRE(r.results.size() == 100000);
+      REQUIRE(r.failures.size() == 100);
+      bool in_order{true};
+      for (int i{0}; i < 100000; ++i) {
+        if (i % 1000 != 999 && r.results[i] != i + 1) {
+          in_order = false;
+        }
+      }
+      REQUIRE(in_order);
+      REQUIRE(r.failures.front() == 999);
+      REQUIRE(r.failures.back() == 99999);
+    }
+  }
+}
@@ -0,0 +1,42 @@
+#define __USE_PARSER_PROFILING__
+#include <attoparsecpp/profile.hpp>
+
+#include <sstream>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace apl;
+
+SCENARIO("profiled parsers", "[profile]") {
+  profile_reset();
+  GIVEN("a grammar of named rules") {
+    const auto number{named(token(integer), "test.number")};
+    const auto list{named(sep_by1(number, token(oneOf(','))), "test.list")};
+    WHEN("parsing a list") {
+      REQUIRE(parse_result(list, "1, 2, 3") == std::vector<int>{1, 2, 3});
+      const rule_profile &n{profile_of("test.number")};
+      const rule_profile &l{profile_of("test.list")};
+      REQUIRE(n.calls == 3);
+      REQUIRE(n.successes == 3);
+      REQUIRE(n.bytes == 3);
+      REQUIRE(l.calls == 1);
+      REQUIRE(l.bytes == 7);
+      REQUIRE(l.ticks >= n.ticks);
+    }
+    WHEN("parsing fails") {
+      REQUIRE(!parse_result(list, "x"));
+      REQUIRE(profile_of("test.number").calls == 1);
+      REQUIRE(profile_of("test.number").successes == 0);
+      REQUIRE(profile_of("test.list").bytes == 0);
+    }
+    WHEN("printing a report") {
+      parse_result(list, "1");
+      std::ostringstream os;
+      profile_report(os);
+      const auto report{os.str()};
+      REQUIRE(report.find("test.number") != std::string::npos);
+      REQUIRE(report.find("test.list") < report.find("test.number"));
+    }
+  }
+}
@@ -0,0 +1,20 @@
+#include <attoparsecpp/profile.hpp>
+
+#include <sstream>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace apl;
+
+// Linked together with profile.cpp, which enables profiling.
+SCENARIO("parsers without profiling", "[profile]") {
+  GIVEN("a named rule") {
+    const auto number{named(integer, "test.off.number")};
+    REQUIRE(parse_result(number, "12") == 12);
+    THEN("the report stays empty") {
+      std::ostringstream os;
+      profile_report(os);
+      REQUIRE(os.str().empty());
+    }
+  }
+}
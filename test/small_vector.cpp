@@ -0,0 +1,91 @@
+#include <attoparsecpp/small_vector.hpp>
+
+#include <memory>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace apl;
+
+SCENARIO("small vector", "[small_vector]") {
+  GIVEN("no more items than inline slots") {
+    small_vector<int, 4> v;
+    REQUIRE(v.empty());
+    for (int i{0}; i < 4; ++i) {
+      v.push_back(i);
+    }
+    REQUIRE(v.is_inline());
+    REQUIRE(v == small_vector<int, 4>{0, 1, 2, 3});
+  }
+  GIVEN("more items than inline slots") {
+    small_vector<std::string, 2> v{"a", "b"};
+    v.emplace_back("a string beyond SSO");
+    v.push_back(v.front());
+    REQUIRE(!v.is_inline());
+    REQUIRE(v.capacity() == 4);
+    REQUIRE(v == small_vector<std::string, 2>{"a", "b",
+                                              "a string beyond SSO", "a"});
+    WHEN("it is cleared") {
+      v.clear();
+      REQUIRE(v.empty());
+      REQUIRE(v.capacity() == 4);
+    }
+  }
+  GIVEN("copies and moves") {
+    small_vector<std::unique_ptr<int>, 2> inline_items;
+    inline_items.push_back(std::make_unique<int>(1));
+    small_vector<std::unique_ptr<int>, 2> heap_items;
+    for (int i{0}; i < 3; ++i) {
+      heap_items.push_back(std::make_unique<int>(i));
+    }
+    const int *const heap_data{heap_items[0].get()};
+
+    auto moved_inline{std::move(inline_items)};
+    REQUIRE(moved_inline.size() == 1);
+    REQUIRE(*moved_inline[0] == 1);
+    REQUIRE(inline_items.empty());
+
+    auto moved_heap{std::move(heap_items)};
+    REQUIRE(moved_heap.size() == 3);
+    REQUIRE(moved_heap[0].get() == heap_data);
+    REQUIRE(heap_items.empty());
+    REQUIRE(heap_items.is_inline());
+
+    moved_heap = std::move(moved_inline);
+    REQUIRE(moved_heap.size() == 1);
+    REQUIRE(*moved_heap[0] == 1);
+
+    const small_vector<std::string, 1> a{"x", "y"};
+    small_vector<std::string, 1> b{a};
+    REQUIRE(b == a);
+    b = small_vector<std::string, 1>{"z"};
+    REQUIRE(b.size() == 1);
+    b = a;
+    REQUIRE(b == a);
+  }
+}
+
+SCENARIO("small vector parsers", "[small_vector]") {
+  GIVEN("manyV_small") {
+    const auto p{manyV_small<4>(token(integer))};
+    const auto r{parse_result(p, "1 2 3")};
+    REQUIRE(r == small_vector<int, 4>{1, 2, 3});
+    REQUIRE(r->is_inline());
+    const auto spilled{parse_result(p, "1 2 3 4 5")};
+    REQUIRE(spilled == small_vector<int, 4>{1, 2, 3, 4, 5});
+    REQUIRE(!spilled->is_inline());
+    REQUIRE(parse_result(p, "")->empty());
+    REQUIRE(!parse_result(manyV_small<4>(token(integer), true), ""));
+  }
+  GIVEN("sep_by_small") {
+    const auto p{sep_by_small<2>(integer, oneOf(','))};
+    REQUIRE(parse_result(p, "1,2") == small_vector<int, 2>{1, 2});
+    REQUIRE(parse_result(p, "1,2,3") == small_vector<int, 2>{1, 2, 3});
+    REQUIRE(!parse_result(sep_by_small<2>(integer, oneOf(','), true), ""));
+  }
+  GIVEN("manyV_into with a small vector") {
+    small_vector<int, 4> v;
+    REQUIRE(parse_into(manyV_into(token(integer)), "4 5", v));
+    REQUIRE(v == small_vector<int, 4>{4, 5});
+  }
+}
@@ -1,4 +1,7 @@
+#include <array>
+#include <functional>
 #include <iterator>
+#include <memory_resource>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -73,7 +76,69 @@ SCENARIO("Fundamental parsers", "[parser]") {
       REQUIRE(r.first == "abcdef"s);
       REQUIRE(r.second.peek() == 'g');
     }
+    WHEN("given partly correct string, nothing is consumed") {
+      const std::string s{"abcxyz"};
+      const auto r{run_parser(p, s)};
+      REQUIRE(!r.first);
+      REQUIRE(r.second.size() == s.size());
+    }
   }
+  GIVEN("const_string_view") {
+    const auto p{const_string_view("abc")};
+    WHEN("given bad string") {
+      const auto r{run_parser(p, "abx")};
+      REQUIRE(!r.first);
+    }
+    WHEN("given correct string plus suffix") {
+      const std::string s{"abcd"};
+      const auto r{run_parser(p, s)};
+      REQUIRE(r.first == std::string_view{"abc"});
+      REQUIRE(r.first->data() == s.data());
+      REQUIRE(r.second.peek() == 'd');
+    }
+  }
+  GIVEN("skip_string") {
+    const auto p{skip_string("abc")};
+    WHEN("given too short string") {
+      const auto r{run_parser(p, "ab")};
+      REQUIRE(!r.first);
+    }
+    WHEN("given correct string plus suffix") {
+      const std::string s{"abcd"};
+      const auto r{run_parser(p, s)};
+      REQUIRE(r.first == unit{});
+      REQUIRE(r.second.peek() == 'd');
+    }
+  }
+}
+
+SCENARIO("input buffers", "[parser]") {
+  const auto p{many_view(noneOf(' '))};
+  GIVEN("a std::string_view") {
+    const std::string_view s{"abc def"};
+    const auto r{run_parser(p, s)};
+    REQUIRE(r.first == std::string_view{"abc"});
+    REQUIRE(r.second.peek() == ' ');
+  }
+  GIVEN("a std::vector<char> as pointer and length") {
+    const std::vector<char> v{'a', 'b', ' ', 'c'};
+    const auto r{run_parser(p, str_pos{v.data(), v.size()})};
+    REQUIRE(r.first == std::string_view{"ab"});
+    REQUIRE(r.second.size() == 2);
+  }
+  GIVEN("a buffer without terminating zero") {
+    const char buf[]{'a', 'b', 'c'};
+    const auto r{run_parser(p, str_pos{std::begin(buf), std::end(buf)})};
+    REQUIRE(r.first == std::string_view{"abc"});
+    REQUIRE(r.second.at_end());
+  }
+#ifdef __cpp_lib_span
+  GIVEN("a std::span<const char>") {
+    const std::vector<char> v{'a', 'b', ' ', 'c'};
+    const auto r{run_parser(p, std::span<const char>{v})};
+    REQUIRE(r.first == std::string_view{"ab"});
+  }
+#endif
 }
 
 SCENARIO("many parser combinations", "[parser]") {
@@ -113,6 +178,201 @@ SCENARIO("many parser combinations", "[parser]") {
   }
 }
 
+SCENARIO("view parser combinations", "[parser]") {
+  GIVEN("many_view noneOf 'a'") {
+    const auto p{many_view(noneOf('a'))};
+    WHEN("given list of 'a's") {
+      const std::string s{"aaa"};
+      const auto r{run_parser(p, s)};
+      REQUIRE(!!r.first);
+      REQUIRE(r.first->empty());
+      REQUIRE(r.second.size() == 3);
+    }
+    WHEN("given bba") {
+      const std::string s{"bba"};
+      const auto r{run_parser(p, s)};
+      REQUIRE(!!r.first);
+      REQUIRE(*r.first == "bb");
+      REQUIRE(r.first->data() == s.data());
+      REQUIRE(r.second.peek() == 'a');
+    }
+  }
+  GIVEN("many1_view oneOf 'b'") {
+    const auto p{many1_view(oneOf('b'))};
+    WHEN("given an empty string") {
+      const auto r{run_parser(p, "")};
+      REQUIRE(!r.first);
+    }
+    WHEN("given list of 'a's") {
+      const auto r{run_parser(p, "aaa")};
+      REQUIRE(!r.first);
+    }
+    WHEN("given bba") {
+      const std::string s{"bba"};
+      const auto r{run_parser(p, s)};
+      REQUIRE(!!r.first);
+      REQUIRE(*r.first == "bb");
+      REQUIRE(r.second.peek() == 'a');
+    }
+  }
+  GIVEN("take_while lowercase") {
+    const auto lower{[](char c) { return 'a' <= c && c <= 'z'; }};
+    WHEN("given a word followed by a space") {
+      const std::string s{"abc def"};
+      const auto r{run_parser(take_while(lower), s)};
+      REQUIRE(!!r.first);
+      REQUIRE(*r.first == "abc");
+      REQUIRE(r.second.peek() == ' ');
+    }
+    WHEN("given the whole input matches") {
+      const std::string s{"abc"};
+      const auto r{run_parser(take_while(lower), s)};
+      REQUIRE(!!r.first);
+      REQUIRE(*r.first == "abc");
+      REQUIRE(r.second.at_end());
+    }
+    WHEN("given non-matching input to take_while1") {
+      const auto r{run_parser(take_while1(lower), "123")};
+      REQUIRE(!r.first);
+    }
+  }
+}
+
+SCENARIO("skip parser combinations", "[parser]") {
+  GIVEN("skip_many oneOf ' '") {
+    const auto p{skip_many(oneOf(' '))};
+    WHEN("given an empty string") {
+      const auto r{run_parser(p, "")};
+      REQUIRE(r.first == unit{});
+    }
+    WHEN("given spaces followed by a word") {
+      const std::string s{"   ab"};
+      const auto r{run_parser(p, s)};
+      REQUIRE(r.first == unit{});
+      REQUIRE(r.second.peek() == 'a');
+    }
+  }
+  GIVEN("skip_many1 oneOf ' '") {
+    const auto p{skip_many1(oneOf(' '))};
+    WHEN("given a word") {
+      const auto r{run_parser(p, "ab")};
+      REQUIRE(!r.first);
+    }
+    WHEN("given a space followed by a word") {
+      const std::string s{" ab"};
+      const auto r{run_parser(p, s)};
+      REQUIRE(!!r.first);
+      REQUIRE(r.second.peek() == 'a');
+    }
+  }
+  GIVEN("skip_while digit") {
+    const auto digit{[](char c) { return '0' <= c && c <= '9'; }};
+    WHEN("given digits followed by a letter") {
+      const std::string s{"123a"};
+      const auto r{run_parser(skip_while(digit), s)};
+      REQUIRE(!!r.first);
+      REQUIRE(r.second.peek() == 'a');
+    }
+    WHEN("given no digits to skip_while1") {
+      const auto r{run_parser(skip_while1(digit), "a")};
+      REQUIRE(!r.first);
+    }
+  }
+}
+
+SCENARIO("long character runs", "[parser]") {
+  const std::string word(100, 'a');
+  GIVEN("many noneOf over a run longer than a SIMD register") {
+    const std::string s{word + "#rest"};
+    const auto r{run_parser(many(noneOf('#', '$')), s)};
+    REQUIRE(r.first == word);
+    REQUIRE(r.second.peek() == '#');
+  }
+  GIVEN("many_view oneOf with the stop character at every offset") {
+    for (size_t i{0}; i < word.size(); ++i) {
+      std::string s{word};
+      s[i] = 'x';
+      const auto r{run_parser(many_view(oneOf('a', 'b')), s)};
+      REQUIRE(r.first->size() == i);
+      REQUIRE(r.second.size() == s.size() - i);
+    }
+  }
+  GIVEN("skip_many1 over the whole input") {
+    const auto r{run_parser(skip_many1(oneOf('a')), word)};
+    REQUIRE(!!r.first);
+    REQUIRE(r.second.at_end());
+  }
+  GIVEN("runs of every length at every alignment") {
+    // The characters behind the end of the input continue the run, so
+    // reading past the end would show up as a longer run.
+    alignas(32) std::array<char, 128> buffer;
+    const auto scalar_run{[](const char *b, size_t n, auto in_run) {
+      size_t i{0};
+      while (i < n && in_run(b[i])) {
+        ++i;
+      }
+      return i;
+    }};
+    bool same{true};
+    for (size_t offset{0}; offset < 32; ++offset) {
+      for (size_t length{0}; length <= 64; ++length) {
+        for (size_t stop{0}; stop <= length; ++stop) {
+          buffer.fill('a');
+          buffer[offset + stop] = stop == length ? 'a' : '#';
+          const str_pos pos{buffer.data() + offset, length};
+          const auto none{run_parser(many_view(noneOf('#', '$')), pos)};
+          const auto one{run_parser(many_count(oneOf('a', 'b')), pos)};
+          const size_t expected{scalar_run(
+              pos.data(), length, [](char c) { return c != '#'; })};
+          same = same && none.first->size() == expected &&
+                 *one.first == expected &&
+                 none.second.size() == length - expected;
+        }
+      }
+    }
+    REQUIRE(same);
+  }
+}
+
+static_assert(digit_class.contains('0') && digit_class.contains('9'));
+static_assert(!digit_class.contains('a') && !digit_class.contains('/'));
+static_assert((range<'a', 'f'> | chars<'_'>).contains('_'));
+static_assert(!(~alpha_class).contains('x') && (~alpha_class).contains('1'));
+static_assert((alnum_class & hex_digit_class).contains('c'));
+static_assert(range<'\x80', '\xff'>.contains('\xff'));
+static_assert(range<'\0', '\xff'>.contains('\x3f') &&
+              range<'\0', '\xff'>.contains('\x40'));
+// A class is a 256 bit table, and token() without a whitespace class does
+// not carry one around.
+static_assert(sizeof(char_class) == 32);
+static_assert(sizeof(token(integer)) == sizeof(&integer));
+
+SCENARIO("character class parsers", "[parser]") {
+  const auto ident_char{alnum_class | chars<'_'>};
+  GIVEN("sat with a character class") {
+    WHEN("given a matching character") {
+      const auto r{run_parser(sat(ident_char), "_")};
+      REQUIRE(r.first == '_');
+    }
+    WHEN("given a non-matching character") {
+      const auto r{run_parser(sat(ident_char), "-")};
+      REQUIRE(!r.first);
+    }
+  }
+  GIVEN("many sat with a character class") {
+    const std::string s{"foo_bar1-baz"};
+    const auto r{run_parser(many(sat(ident_char)), s)};
+    REQUIRE(r.first == "foo_bar1"s);
+    REQUIRE(r.second.peek() == '-');
+  }
+  GIVEN("token with custom whitespace") {
+    const auto p{manyV(token(many1_view(sat(alpha_class)), space_class))};
+    const auto r{run_parser(p, "a\nbc \r\n d")};
+    REQUIRE(r.first == std::vector<std::string_view>{"a", "bc", "d"});
+    REQUIRE(r.second.at_end());
+  }
+}
+
 SCENARIO("manyV parser combinations") {
   GIVEN("manyV string parser") {
     const auto p{manyV(anyChar)};
@@ -211,6 +471,55 @@ SCENARIO("int parser", "[parser]") {
     REQUIRE(r.first == 12);
     REQUIRE(r.second.size() == 1);
   }
+  GIVEN("hex digits in both cases") {
+    REQUIRE(parse_result(base_integer(16), "aF") == 0xaf);
+    REQUIRE(parse_result(base_integer(16), "1A2b") == 0x1a2b);
+  }
+  GIVEN("long decimal strings of every length") {
+    std::string s;
+    uint64_t expected{0};
+    for (int i{1}; i <= 19; ++i) {
+      s.push_back(static_cast<char>('0' + i % 10));
+      expected = expected * 10 + i % 10;
+      const std::string input{s + "x"};
+      const auto r{run_parser(base_integer<uint64_t>(10), input)};
+      REQUIRE(r.first == expected);
+      REQUIRE(r.second.peek() == 'x');
+    }
+  }
+  GIVEN("16 digits but only parsing the first 10") {
+    const std::string s{"1234567890123456"};
+    const auto r{run_parser(base_integer<int64_t>(10, 10), s)};
+    REQUIRE(r.first == 1234567890);
+    REQUIRE(r.second.size() == 6);
+  }
+  GIVEN("limits of the integer types") {
+    REQUIRE(parse_result(base_integer<int>(10), "2147483647") == 2147483647);
+    REQUIRE(!parse_result(base_integer<int>(10), "2147483648"));
+    REQUIRE(parse_result(base_integer<uint8_t>(10), "255") == 255);
+    REQUIRE(!parse_result(base_integer<uint8_t>(10), "256"));
+    REQUIRE(parse_result(base_integer<int64_t>(10), "9223372036854775807") ==
+            INT64_MAX);
+    REQUIRE(!parse_result(base_integer<int64_t>(10), "9223372036854775808"));
+    REQUIRE(parse_result(base_integer<uint64_t>(10),
+                         "18446744073709551615") == UINT64_MAX);
+    REQUIRE(!parse_result(base_integer<uint64_t>(10), "18446744073709551616"));
+    REQUIRE(parse_result(base_integer<uint64_t>(16), "ffffffffffffffff") ==
+            UINT64_MAX);
+    REQUIRE(!parse_result(base_integer<uint64_t>(16), "10000000000000000"));
+  }
+  GIVEN("16 hex digits") {
+    REQUIRE(parse_result(base_integer<int64_t>(16), "7fffffffffffffff") ==
+            INT64_MAX);
+    REQUIRE(!parse_result(base_integer<int64_t>(16), "8000000000000000"));
+    REQUIRE(parse_result(base_integer<uint64_t>(16), "FfFfFfFfFfFfFfFf") ==
+            UINT64_MAX);
+  }
+  GIVEN("octal digits followed by a decimal digit") {
+    const auto r{run_parser(base_integer(8), "178")};
+    REQUIRE(r.first == 017);
+    REQUIRE(r.second.peek() == '8');
+  }
 }
 
 SCENARIO("auto int parser", "[parser]") {
@@ -222,6 +531,13 @@ SCENARIO("auto int parser", "[parser]") {
     const auto r{run_parser(integer, "0")};
     REQUIRE(r.first == 0);
   }
+  GIVEN("a zero followed by a non-octal digit") {
+    for (const auto s : {"08", "09"}) {
+      const auto r{run_parser(integer, s)};
+      REQUIRE(r.first == 0);
+      REQUIRE(r.second.size() == 1);
+    }
+  }
   GIVEN("string '0 '") {
     const std::string s{"0 "};
     const auto r{run_parser(integer, s)};
@@ -253,6 +569,60 @@ SCENARIO("auto int parser", "[parser]") {
     const auto r{run_parser(integer, "0x123abc")};
     REQUIRE(r.first == 0x123abc);
   }
+  GIVEN("string '0X123ABC'") {
+    const auto r{run_parser(integer, "0X123ABC")};
+    REQUIRE(r.first == 0x123abc);
+  }
+  GIVEN("string '0xAbC'") {
+    const auto r{run_parser(integer, "0xAbC")};
+    REQUIRE(r.first == 0xabc);
+  }
+  GIVEN("a hex prefix without digits") {
+    for (const auto s : {"0x", "0X", "0xg"}) {
+      REQUIRE(!parse_result(integer, s));
+    }
+  }
+}
+
+SCENARIO("floating point parser", "[parser]") {
+  GIVEN("empty string") {
+    REQUIRE(!parse_result(double_, ""));
+  }
+  GIVEN("strings that are no number") {
+    REQUIRE(!parse_result(double_, "abc"));
+    REQUIRE(!parse_result(double_, "-"));
+    REQUIRE(!parse_result(double_, "."));
+    REQUIRE(!parse_result(double_, "e5"));
+  }
+  GIVEN("integral and fractional numbers") {
+    REQUIRE(parse_result(double_, "1") == 1.0);
+    REQUIRE(parse_result(double_, "-12.5") == -12.5);
+    REQUIRE(parse_result(double_, "+0.25") == 0.25);
+    REQUIRE(parse_result(double_, ".5") == 0.5);
+    REQUIRE(parse_result(double_, "0.1") == 0.1);
+    REQUIRE(parse_result(float_, "0.1") == 0.1f);
+  }
+  GIVEN("scientific notation") {
+    REQUIRE(parse_result(double_, "1e3") == 1000.0);
+    REQUIRE(parse_result(double_, "2.5E-3") == 2.5e-3);
+    REQUIRE(parse_result(double_, "-1.7976931348623157e308") ==
+            -1.7976931348623157e308);
+  }
+  GIVEN("an exponent marker without exponent digits") {
+    const std::string s{"1.5e+x"};
+    const auto r{run_parser(double_, s)};
+    REQUIRE(r.first == 1.5);
+    REQUIRE(r.second.peek() == 'e');
+  }
+  GIVEN("a number out of range") {
+    REQUIRE(!parse_result(double_, "1e400"));
+    REQUIRE(!parse_result(float_, "1e40"));
+  }
+  GIVEN("a list of numbers") {
+    const auto r{run_parser(manyV(token(double_)), "1.5 -2 3e2")};
+    REQUIRE(r.first == std::vector<double>{1.5, -2.0, 300.0});
+    REQUIRE(r.second.at_end());
+  }
 }
 
 SCENARIO("prefix/postfix parser", "[parser]") {
@@ -436,4 +806,322 @@ SCENARIO("choice parsers", "[parser]") {
       REQUIRE(r.second.peek() == ' ');
     }
   }
+  GIVEN("choice of keywords sharing first characters") {
+    const auto ident{
+        map(many1(sat(alpha_class)), [](const std::string &) {
+          return "ident"s;
+        })};
+    const auto p{choice(const_string("let"), const_string("loop"),
+                        const_string("if"), ident)};
+    WHEN("given the second keyword") {
+      const auto r{run_parser(p, "loop")};
+      REQUIRE(r.first == "loop"s);
+    }
+    WHEN("given a word that only matches the fallback alternative") {
+      const auto r{run_parser(p, "lamp")};
+      REQUIRE(r.first == "ident"s);
+    }
+    WHEN("given a character no alternative accepts") {
+      const auto r{run_parser(p, "1")};
+      REQUIRE(!r.first);
+    }
+  }
+  GIVEN("choice with an alternative that matches empty input") {
+    const auto p{choice(const_string("a"), many(oneOf('b')))};
+    WHEN("given an empty string") {
+      const auto r{run_parser(p, "")};
+      REQUIRE(r.first == ""s);
+    }
+    WHEN("given a") {
+      const auto r{run_parser(p, "a")};
+      REQUIRE(r.first == "a"s);
+    }
+    WHEN("given bb") {
+      const auto r{run_parser(p, "bb")};
+      REQUIRE(r.first == "bb"s);
+    }
+  }
+  GIVEN("choice of noneOf and oneOf") {
+    const auto p{choice(noneOf('x', 'y'), oneOf('y'))};
+    REQUIRE(parse_result(p, "a") == 'a');
+    REQUIRE(parse_result(p, "y") == 'y');
+    REQUIRE(!parse_result(p, "x"));
+  }
+}
+
+SCENARIO("attempt parser", "[parser]") {
+  GIVEN("a choice over attempted alternatives sharing a prefix") {
+    const auto p{choice(attempt(tuple_of(oneOf('a'), oneOf('b'))),
+                        tuple_of(oneOf('a'), oneOf('c')))};
+    WHEN("given the second alternative") {
+      const auto r{run_parser(p, "ac")};
+      REQUIRE(r.first == std::make_tuple('a', 'c'));
+      REQUIRE(r.second.at_end());
+    }
+  }
+  GIVEN("a failing attempt") {
+    const std::string s{"abx"};
+    const auto r{run_parser(
+        attempt(tuple_of(oneOf('a'), oneOf('b'), oneOf('c'))), s)};
+    REQUIRE(!r.first);
+    REQUIRE(r.second.size() == s.size());
+  }
+}
+
+SCENARIO("allocator aware parsers", "[parser]") {
+  std::array<std::byte, 4096> buffer;
+  std::pmr::monotonic_buffer_resource arena{
+      buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+  const std::pmr::polymorphic_allocator<std::byte> alloc{&arena};
+  GIVEN("many_alloc") {
+    const auto r{
+        parse_result(many_alloc(noneOf(','), alloc), "a string beyond SSO,")};
+    REQUIRE(r == std::pmr::string{"a string beyond SSO"});
+    REQUIRE(r->get_allocator().resource() == &arena);
+  }
+  GIVEN("nested sep_by_alloc and manyV_alloc") {
+    const auto item{token(integer)};
+    const auto list{clasped(oneOf('['), oneOf(']'),
+                            sep_by_alloc(item, token(oneOf(',')), alloc))};
+    const auto p{manyV_alloc(token(list), alloc)};
+    const auto r{parse_result(p, "[1, 2] [] [3]")};
+    REQUIRE(!!r);
+    REQUIRE(r->size() == 3);
+    REQUIRE((*r)[0] == std::pmr::vector<int>{1, 2});
+    REQUIRE((*r)[1].empty());
+    REQUIRE((*r)[2] == std::pmr::vector<int>{3});
+    REQUIRE((*r)[0].get_allocator().resource() == &arena);
+  }
+}
+
+SCENARIO("parsing into caller-owned containers", "[parser]") {
+  GIVEN("manyV_into") {
+    const auto p{manyV_into(token(integer))};
+    std::vector<int> v;
+    REQUIRE(parse_into(p, "1 2 3", v));
+    REQUIRE(v == std::vector<int>{1, 2, 3});
+    const int *const data{v.data()};
+    WHEN("parsing a shorter input") {
+      REQUIRE(parse_into(p, "4 5", v));
+      REQUIRE(v == std::vector<int>{4, 5});
+      REQUIRE(v.data() == data);
+    }
+    WHEN("parsing an empty input") {
+      REQUIRE(parse_into(p, "", v));
+      REQUIRE(v.empty());
+      REQUIRE(!parse_into(manyV_into(token(integer), true), "", v));
+    }
+    WHEN("running the filling parser directly") {
+      str_pos pos{"7 8 x"};
+      REQUIRE(p(pos, v) == 2);
+      REQUIRE(v == std::vector<int>{7, 8});
+      REQUIRE(pos.peek() == 'x');
+    }
+  }
+  GIVEN("sep_by_into") {
+    const auto p{sep_by_into(integer, oneOf(','))};
+    std::vector<int> v;
+    REQUIRE(parse_into(p, "1,2,3", v));
+    REQUIRE(v == std::vector<int>{1, 2, 3});
+    REQUIRE(parse_into(p, "4", v));
+    REQUIRE(v == std::vector<int>{4});
+    REQUIRE(!parse_into(sep_by_into(integer, oneOf(','), true), "", v));
+  }
+  GIVEN("parsers without a filling variant") {
+    int i{0};
+    REQUIRE(parse_into(integer, "42", i));
+    REQUIRE(i == 42);
+    REQUIRE(!parse_into(integer, "x", i));
+    REQUIRE(i == 42);
+  }
+}
+
+SCENARIO("fold parsers", "[parser]") {
+  const auto plus{[](int a, int b) { return a + b; }};
+  GIVEN("many_fold over integer tokens") {
+    const auto p{many_fold(token(integer), 0, plus)};
+    WHEN("given an empty string") {
+      REQUIRE(parse_result(p, "") == 0);
+      REQUIRE(!parse_result(many_fold(token(integer), 0, plus, true), ""));
+    }
+    WHEN("given several integers") {
+      const auto r{run_parser(p, "1 2 3 x")};
+      REQUIRE(r.first == 6);
+      REQUIRE(r.second.peek() == 'x');
+    }
+  }
+  GIVEN("sep_by_fold computing the maximum") {
+    const auto max{[](int a, int b) { return a < b ? b : a; }};
+    const auto p{sep_by_fold(integer, oneOf(','), 0, max)};
+    REQUIRE(parse_result(p, "3,9,4") == 9);
+  }
+  GIVEN("many_count") {
+    REQUIRE(parse_result(many_count(oneOf('a')), "aaab") == 3);
+    REQUIRE(parse_result(many_count(token(integer)), "1 2 3") == 3);
+    REQUIRE(parse_result(many_count(anyChar), "") == 0);
+  }
+}
+
+SCENARIO("expression parser", "[parser]") {
+  const auto arith{[](char op, int a, int b) {
+    switch (op) {
+    case '+':
+      return a + b;
+    case '-':
+      return a - b;
+    default:
+      return a * b;
+    }
+  }};
+  const auto power{[](char, int a, int b) {
+    int r{1};
+    while (b-- > 0) {
+      r *= a;
+    }
+    return r;
+  }};
+  const auto negate{[](char, int a) { return -a; }};
+  const auto factorial{[](char, int a) {
+    int r{1};
+    while (a > 1) {
+      r *= a--;
+    }
+    return r;
+  }};
+  GIVEN("a table with all kinds of operators") {
+    const auto p{expression(
+        token(integer),
+        operator_table(infix_left(token(oneOf('+', '-')), arith),
+                       infix_left(token(oneOf('*')), arith),
+                       prefix(token(oneOf('-')), negate),
+                       infix_right(token(oneOf('^')), power),
+                       postfix(token(oneOf('!')), factorial)))};
+    WHEN("given a single atom") { REQUIRE(parse_result(p, "42") == 42); }
+    WHEN("given left associative operators") {
+      REQUIRE(parse_result(p, "10 - 4 - 3") == 3);
+      REQUIRE(parse_result(p, "1 + 2 * 3 + 4") == 11);
+    }
+    WHEN("given right associative operators") {
+      REQUIRE(parse_result(p, "2 ^ 3 ^ 2") == 512);
+    }
+    WHEN("given prefix operators") {
+      REQUIRE(parse_result(p, "2 - -3") == 5);
+      REQUIRE(parse_result(p, "--3") == 3);
+      REQUIRE(parse_result(p, "-2 ^ 2") == -4);
+      REQUIRE(!parse_result(p, "-"));
+    }
+    WHEN("given postfix operators") {
+      REQUIRE(parse_result(p, "3! + 1") == 7);
+      REQUIRE(parse_result(p, "2 * 3!") == 12);
+      REQUIRE(parse_result(p, "3!!") == 720);
+    }
+    WHEN("given a trailing operator") {
+      const auto r{run_parser(p, "1 + 2 *")};
+      REQUIRE(r.first == 3);
+      REQUIRE(r.second.at_end());
+    }
+    WHEN("given no atom") { REQUIRE(!parse_result(p, "+ 1")); }
+  }
+  GIVEN("operators that yield functions like in chainl1") {
+    const auto plus{map(token(oneOf('+')), [](char) {
+      return std::plus<int>{};
+    })};
+    const auto p{expression(token(integer), operator_table(infix_left(plus)))};
+    REQUIRE(parse_result(p, "1 + 2 + 3") == 6);
+  }
+}
+
+SCENARIO("recursive rules", "[parser]") {
+  GIVEN("a rule for nested lists that counts the lists") {
+    rule<size_t> lists;
+    lists = map(clasped(oneOf('['), oneOf(']'), sep_by(lists, oneOf(','))),
+                [](const std::vector<size_t> &inner) {
+                  size_t n{1};
+                  for (size_t i : inner) {
+                    n += i;
+                  }
+                  return n;
+                });
+    REQUIRE(parse_result(lists, "[]") == 1);
+    REQUIRE(parse_result(lists, "[[],[[]],[]]") == 5);
+    REQUIRE(!parse_result(lists, "[[]"));
+  }
+  GIVEN("rules that refer to each other") {
+    rule<int> factor;
+    const auto plus{map(oneOf('+'), [](char) { return std::plus<int>{}; })};
+    const auto sum{chainl1(factor, plus)};
+    factor = choice(integer, clasped(oneOf('('), oneOf(')'), sum));
+    REQUIRE(parse_result(sum, "1+(2+(3+4))+5") == 15);
+  }
+  GIVEN("a copy of a rule") {
+    rule<int> original;
+    rule<int> copy{original};
+    WHEN("the copy is defined") {
+      copy = integer;
+      THEN("both run the same definition") {
+        REQUIRE(parse_result(original, "12") == 12);
+        REQUIRE(parse_result(copy, "34") == 34);
+      }
+    }
+  }
+  GIVEN("rules returned from a function") {
+    const auto make_rule{[] {
+      rule<int> r;
+      r = integer;
+      return r;
+    }};
+    const auto make_doubled{[] {
+      rule<int> r;
+      r = integer;
+      return map(r, [](int i) { return 2 * i; });
+    }};
+    REQUIRE(parse_result(make_rule(), "21") == 21);
+    REQUIRE(parse_result(make_doubled(), "21") == 42);
+  }
+}
+
+SCENARIO("parsers with a declared first set", "[parser]") {
+  GIVEN("a choice over opaque parsers") {
+    size_t calls{0};
+    const auto counted{[&calls](char c) {
+      return [&calls, c](str_pos &pos) -> parser<char> {
+        ++calls;
+        return oneOf(c)(pos);
+      };
+    }};
+    const auto p{choice_first(with_first_set(chars<'a'>, counted('a')),
+                              with_first_set(chars<'b'>, counted('b')),
+                              with_first_set(chars<'c'>, counted('c')))};
+    WHEN("parsing the last alternative") {
+      REQUIRE(parse_result(p, "c") == 'c');
+      THEN("only that alternative runs") { REQUIRE(calls == 1); }
+    }
+    WHEN("no alternative matches") {
+      REQUIRE(!parse_result(p, "d"));
+      REQUIRE(calls == 0);
+    }
+  }
+  GIVEN("choice_first over keywords and a fallback") {
+    const auto ident{
+        map(many1(sat(alpha_class)), [](const std::string &) {
+          return "ident"s;
+        })};
+    const auto p{choice_first(const_string("let"), const_string("loop"),
+                              const_string("if"), ident)};
+    REQUIRE(parse_result(p, "loop") == "loop"s);
+    REQUIRE(parse_result(p, "lamp") == "ident"s);
+    REQUIRE(!parse_result(p, "1"));
+  }
+  GIVEN("choice_first with an alternative that matches empty input") {
+    const auto p{choice_first(const_string("a"), many(oneOf('b')))};
+    REQUIRE(parse_result(p, "") == ""s);
+    REQUIRE(parse_result(p, "a") == "a"s);
+    REQUIRE(parse_result(p, "bb") == "bb"s);
+  }
+  GIVEN("choice_first of noneOf and oneOf") {
+    const auto p{choice_first(noneOf('x', 'y'), oneOf('y'))};
+    REQUIRE(parse_result(p, "a") == 'a');
+    REQUIRE(parse_result(p, "y") == 'y');
+    REQUIRE(!parse_result(p, "x"));
+  }
 }